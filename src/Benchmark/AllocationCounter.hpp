@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef BENCHMARK_ALLOCATIONCOUNTER_H_
+#define BENCHMARK_ALLOCATIONCOUNTER_H_
+#include <atomic>
+
+/**
+ * counters incremented by the replaced global operator new of the benchmark binary
+ */
+class Benchmark_AllocationCounter
+{
+	public: static std::atomic<unsigned long>& count() {
+		static std::atomic<unsigned long> count(0);
+		return count;
+	}
+
+	public: static std::atomic<unsigned long>& bytes() {
+		static std::atomic<unsigned long> bytes(0);
+		return bytes;
+	}
+
+	public: static void add(std::size_t size) {
+		Benchmark_AllocationCounter::count()++;
+		Benchmark_AllocationCounter::bytes() += size;
+	}
+};
+
+#endif /* BENCHMARK_ALLOCATIONCOUNTER_H_ */
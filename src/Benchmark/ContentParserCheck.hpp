@@ -0,0 +1,388 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef BENCHMARK_CONTENTPARSERCHECK_H_
+#define BENCHMARK_CONTENTPARSERCHECK_H_
+#include <string>
+#include <list>
+#include <vector>
+#include <functional>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include "../Model/DeviceDataList.hpp"
+#include "../Model/MountTable.hpp"
+#include "../Model/Entry.hpp"
+#include "../lib/ContentParser/Tokenizer.hpp"
+#include "../lib/ContentParser/Linux.hpp"
+#include "../lib/ContentParser/LinuxIso.hpp"
+#include "../lib/ContentParser/Chainloader.hpp"
+#include "../lib/ContentParser/Memtest.hpp"
+#include "../lib/Regex.hpp"
+
+/**
+ * Differential check of ContentParser_Tokenizer against the patterns of the content parsers:
+ * for every entry of the corpus both have to agree whether the entry matches and
+ * on every capture group used by the parser. The corpus consists of generated entries
+ * and of entries taken from grub.cfg files written by grub-mkconfig.
+ */
+class Benchmark_ContentParserCheck
+{
+	private: struct Pattern
+	{
+		std::string name;
+		char const* regex;
+		std::function<std::vector<std::string> (ContentParser_Tokenizer const&)> match;
+		size_t groupCount; // groups 1..groupCount are compared
+	};
+
+	private: std::list<Pattern> patterns;
+	public: std::list<std::string> corpus;
+
+	public: Benchmark_ContentParserCheck()
+	{
+		this->addPattern("linux", ContentParser_Linux::_regex, &ContentParser_Tokenizer::matchLinux, 9);
+		this->addPattern("linux-iso", ContentParser_LinuxIso::_regex, &ContentParser_Tokenizer::matchLinuxIso, 8);
+		this->addPattern("chainloader", ContentParser_Chainloader::_regex, &ContentParser_Tokenizer::matchChainloader, 3);
+		this->addPattern("memtest", ContentParser_Memtest::_regex, &ContentParser_Tokenizer::matchMemtest, 4);
+		this->buildCorpus();
+		this->addRealSamples();
+	}
+
+	// adds all menuentries (also the ones inside of submenus) of the given grub.cfg
+	public: void addGrubCfg(FILE* grubCfg)
+	{
+		std::shared_ptr<Model_Entry> entry;
+		while (*(entry = std::make_shared<Model_Entry>(grubCfg))) {
+			this->addEntry(*entry);
+		}
+	}
+
+	private: void addEntry(Model_Entry const& entry)
+	{
+		if (entry.type == Model_Entry::MENUENTRY) {
+			this->corpus.push_back(entry.content);
+		}
+		for (auto& subEntry : entry.subEntries) {
+			this->addEntry(*subEntry);
+		}
+	}
+
+	/**
+	 * returns a description of each difference
+	 */
+	public: std::list<std::string> run(Regex& regexEngine) const
+	{
+		std::list<std::string> differences;
+		for (auto& entry : this->corpus) {
+			ContentParser_Tokenizer tokenizer(entry);
+			for (auto& pattern : this->patterns) {
+				std::vector<std::string> expected, actual;
+				bool expectedMatch = true, actualMatch = true;
+				try {
+					expected = regexEngine.match(pattern.regex, entry, '\\', '_');
+				} catch (RegExNotMatchedException const& e) {
+					expectedMatch = false;
+				}
+				try {
+					actual = pattern.match(tokenizer);
+				} catch (ParserException const& e) {
+					actualMatch = false;
+				}
+				expected.resize(pattern.groupCount + 1);
+
+				std::ostringstream difference;
+				if (expectedMatch != actualMatch) {
+					difference << (expectedMatch ? "not matched" : "matched");
+				} else if (expectedMatch) {
+					for (size_t group = 1; group <= pattern.groupCount; group++) {
+						if (expected[group] != actual[group]) {
+							difference << "group " << group << ": '" << actual[group] << "' instead of '" << expected[group] << "' ";
+						}
+					}
+				}
+				if (difference.str() != "") {
+					differences.push_back(pattern.name + " " + difference.str() + "in:\n" + entry);
+				}
+			}
+		}
+		return differences;
+	}
+
+	private: void addPattern(
+		std::string const& name,
+		char const* regex,
+		std::vector<std::string> (ContentParser_Tokenizer::*match)() const,
+		size_t groupCount
+	) {
+		Pattern pattern;
+		pattern.name = name;
+		pattern.regex = regex;
+		pattern.match = std::mem_fn(match);
+		pattern.groupCount = groupCount;
+		this->patterns.push_back(pattern);
+	}
+
+	// combinations of valid and broken lines of all entry types
+	private: void buildCorpus()
+	{
+		std::list<std::string> prefixes = {
+			"",
+			"\tinsmod part_msdos\n\tinsmod ext2\n",
+			"set root='(hd9,9)'\n"
+		};
+		std::list<std::string> setRootLines = {
+			"\tset root='(hd0,1)'\n",
+			"set root='(hd1,msdos12)'\n",
+			"  set  root='(hd0,1)'\n",
+			"\tset\troot='(hd0,2)'\n",
+			"\treset root='(hd2,3)'\n",
+			"\tset root='(hd0,1)' \n",
+			"\tset root='hd0,msdos1'\n",
+			"\tset root='(hd0)'\n"
+		};
+		std::list<std::string> searchLines = {
+			"\tsearch --no-floppy --fs-uuid --set=root 0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0\n",
+			"search --no-floppy --fs-uuid --set 1234-ABCD\n",
+			"\tsearch  --no-floppy\t--fs-uuid --set=root  1234\n",
+			"\tsearch --no-floppy --fs-uuid --set=root\t1234\n",
+			"\tsearch --no-floppy --fs-uuid --set=root 12 34\n",
+			"\tsearch --fs-uuid --set=root 1234\n"
+		};
+		std::list<std::string> bodies = {
+			// linux
+			"\tlinux /boot/vmlinuz root=UUID=0f1e2d3c-4b5a-6978-8796-a5b4c3d2e1f0 ro quiet splash\n\tinitrd /boot/initrd.img\n",
+			"\techo 'Loading Linux ...'\n\tlinux /vmlinuz root=UUID=1234\n\techo 'Loading initial ramdisk ...'\n\tinitrd /initrd.img\n",
+			"\tlinux \"/boot/my kernel\" root=UUID=abcd ro\n\tinitrd \"/boot/my initrd\"\n\n",
+			"\tlinux \"/boot/a\\\"b\" root=UUID=abcd\n\tinitrd /boot/a\\ b\n",
+			"\tlinux\t/vmlinuz\troot=UUID=1234-x ro\n\tinitrd\t/initrd.img\t\n",
+			"\tlinux /vmlinuz ro root=UUID=1234\n\tinitrd /initrd.img\n",
+			"\tlinux /vmlinuz root=UUID=1234\n\tinitrd /initrd.img /microcode.img\n",
+			"\tlinux /vmlinuz root=UUID=1234\n\tinitrd /initrd.img\n\tboot\n",
+			"\tlinux /vmlinuz root=UUID=1234\n\tinitrd /initrd.img",
+			"\tlinux /vmlinuz root=UUID=1234\n\techo\n\tinitrd /initrd.img\n",
+			"\tlinux \"/vmlinuz root=UUID=1234\n\tinitrd /initrd.img\n",
+			// linux iso
+			"\tloopback loop /iso/ubuntu.iso\n\tlinux (loop)/casper/vmlinuz boot=casper iso-scan/filename=/iso/ubuntu.iso noprompt noeject\n\tinitrd (loop)/casper/initrd.lz\n",
+			"\tloopback loop \"/iso/my ubuntu.iso\"\n\tlinux \"(loop)/casper/vmlinuz\" boot=casper iso-scan/filename=\"/iso/my ubuntu.iso\"\n\tinitrd \"(loop)/casper/initrd.lz\"\n",
+			"loopback\tloop\t/a.iso\nlinux (loop)/vmlinuz boot=casper iso-scan/filename=/b.iso\ninitrd (loop)/initrd.lz",
+			"\tloopback loop /a.iso\n\tlinux /casper/vmlinuz boot=casper iso-scan/filename=/a.iso\n\tinitrd (loop)/casper/initrd.lz\n",
+			"\tloopback loop /a.iso \n\tlinux (loop)/vmlinuz boot=casper iso-scan/filename=/a.iso\n\tinitrd (loop)/initrd.lz\n",
+			"\tloopback loop /a.iso\n\tlinux (loop)/vmlinuz boot=casper iso-scan/filename=/a.iso\n\tinitrd (loop)/initrd.lz\n\techo done\n",
+			"\tloopback loop /a.iso\n\tlinux (loop)/vmlinuz  boot=casper iso-scan/filename=/a.iso\n\tinitrd (loop)/initrd.lz foo\n",
+			// chainloader
+			"\tchainloader +1\n",
+			"\tdrivemap -s (hd0) ${root}\n\tchainloader +1",
+			"\tparttool ${root} hidden-\n\tchainloader\t+1\n\tboot\n",
+			"\tchainloader +2\n",
+			"\txchainloader +1 \n\n",
+			"",
+			// memtest
+			"\tlinux16 /memtest86+.bin\n",
+			"\tlinux16\t\"/boot/mem test.bin\"\n",
+			"\tlinux16/memtest86+.bin\n",
+			"\tlinux16 /memtest86+.bin console=ttyS0\n",
+			"\tlinux16 /memtest86+.bin\n\n",
+			"\tlinux16 /memtest86+.bin\n\tboot\n",
+			"\tlinux16 \"/memtest\"x\n",
+			"\tlinux16\n"
+		};
+		for (auto& prefix : prefixes) {
+			for (auto& setRootLine : setRootLines) {
+				for (auto& searchLine : searchLines) {
+					for (auto& body : bodies) {
+						this->corpus.push_back(prefix + setRootLine + searchLine + body);
+					}
+				}
+			}
+		}
+	}
+
+	// menuentries of grub.cfg files written by grub-mkconfig (10_linux, 20_memtest86+, 30_os-prober) and grub customizer
+	private: void addRealSamples()
+	{
+		FILE* grubCfg = fmemopen((void*) realGrubCfg, strlen(realGrubCfg), "r");
+		if (grubCfg) {
+			this->addGrubCfg(grubCfg);
+			fclose(grubCfg);
+		}
+	}
+
+	private: static const char* realGrubCfg;
+};
+
+const char* Benchmark_ContentParserCheck::realGrubCfg =
+	"### BEGIN /etc/grub.d/10_linux ###\n"
+	"function gfxmode {\n"
+	"\tset gfxpayload=\"${1}\"\n"
+	"}\n"
+	"menuentry 'Ubuntu, with Linux 3.2.0-23-generic' --class ubuntu --class gnu-linux --class gnu --class os {\n"
+	"\trecordfail\n"
+	"\tgfxmode $linux_gfx_mode\n"
+	"\tinsmod gzio\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21\n"
+	"\tlinux\t/boot/vmlinuz-3.2.0-23-generic root=UUID=8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21 ro   quiet splash $vt_handoff\n"
+	"\tinitrd\t/boot/initrd.img-3.2.0-23-generic\n"
+	"}\n"
+	"menuentry 'Ubuntu, with Linux 3.2.0-23-generic (recovery mode)' --class ubuntu --class gnu-linux --class gnu --class os {\n"
+	"\trecordfail\n"
+	"\tinsmod gzio\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21\n"
+	"\techo\t'Loading Linux 3.2.0-23-generic ...'\n"
+	"\tlinux\t/boot/vmlinuz-3.2.0-23-generic root=UUID=8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21 ro recovery nomodeset \n"
+	"\techo\t'Loading initial ramdisk ...'\n"
+	"\tinitrd\t/boot/initrd.img-3.2.0-23-generic\n"
+	"}\n"
+	"menuentry 'Debian GNU/Linux, with Linux 2.6.32-5-686' --class debian --class gnu-linux --class gnu --class os {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos5)'\n"
+	"\tsearch --no-floppy --fs-uuid --set 2b0c6e35-5c3f-4b8e-a2d4-7e1f0c9d3a5b\n"
+	"\techo\t'Loading Linux 2.6.32-5-686 ...'\n"
+	"\tlinux\t/boot/vmlinuz-2.6.32-5-686 root=UUID=2b0c6e35-5c3f-4b8e-a2d4-7e1f0c9d3a5b ro  quiet\n"
+	"\techo\t'Loading initial ramdisk ...'\n"
+	"\tinitrd\t/boot/initrd.img-2.6.32-5-686\n"
+	"}\n"
+	"submenu 'Advanced options for Ubuntu' $menuentry_id_option 'gnulinux-advanced-3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c' {\n"
+	"\tmenuentry 'Ubuntu, with Linux 5.15.0-91-generic' --class ubuntu --class gnu-linux --class gnu --class os $menuentry_id_option 'gnulinux-5.15.0-91-generic-advanced-3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c' {\n"
+	"\t\trecordfail\n"
+	"\t\tload_video\n"
+	"\t\tgfxmode $linux_gfx_mode\n"
+	"\t\tinsmod gzio\n"
+	"\t\tif [ x$grub_platform = xxen ]; then insmod xzio; insmod lzopio; fi\n"
+	"\t\tinsmod part_gpt\n"
+	"\t\tinsmod ext2\n"
+	"\t\tset root='hd0,gpt2'\n"
+	"\t\tif [ x$feature_platform_search_hint = xy ]; then\n"
+	"\t\t  search --no-floppy --fs-uuid --set=root --hint-bios=hd0,gpt2 --hint-efi=hd0,gpt2 --hint-baremetal=ahci0,gpt2  3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c\n"
+	"\t\telse\n"
+	"\t\t  search --no-floppy --fs-uuid --set=root 3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c\n"
+	"\t\tfi\n"
+	"\t\techo\t'Loading Linux 5.15.0-91-generic ...'\n"
+	"\t\tlinux\t/boot/vmlinuz-5.15.0-91-generic root=UUID=3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c ro  quiet splash $vt_handoff\n"
+	"\t\techo\t'Loading initial ramdisk ...'\n"
+	"\t\tinitrd\t/boot/initrd.img-5.15.0-91-generic\n"
+	"\t}\n"
+	"\tmenuentry 'Ubuntu, with Linux 3.0.0-12-generic' --class ubuntu --class gnu-linux --class gnu --class os {\n"
+	"\t\trecordfail\n"
+	"\t\tset gfxpayload=$linux_gfx_mode\n"
+	"\t\tinsmod part_msdos\n"
+	"\t\tinsmod ext2\n"
+	"\t\tset root='(hd0,msdos1)'\n"
+	"\t\tsearch --no-floppy --fs-uuid --set=root 0c1d2e3f-4a5b-6c7d-8e9f-a0b1c2d3e4f5\n"
+	"\t\tlinux\t/boot/vmlinuz-3.0.0-12-generic root=UUID=0c1d2e3f-4a5b-6c7d-8e9f-a0b1c2d3e4f5 ro   quiet splash vt.handoff=7\n"
+	"\t\tinitrd\t/boot/initrd.img-3.0.0-12-generic\n"
+	"\t}\n"
+	"}\n"
+	"### END /etc/grub.d/10_linux ###\n"
+	"\n"
+	"### BEGIN /etc/grub.d/20_memtest86+ ###\n"
+	"menuentry \"Memory test (memtest86+)\" {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21\n"
+	"\tlinux16\t/boot/memtest86+.bin\n"
+	"}\n"
+	"menuentry \"Memory test (memtest86+, serial console 115200)\" {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21\n"
+	"\tlinux16\t/boot/memtest86+.bin console=ttyS0,115200n8\n"
+	"}\n"
+	"menuentry 'Memory test (memtest86+.elf)' {\n"
+	"\tinsmod part_gpt\n"
+	"\tinsmod ext2\n"
+	"\tset root='hd0,gpt2'\n"
+	"\tif [ x$feature_platform_search_hint = xy ]; then\n"
+	"\t  search --no-floppy --fs-uuid --set=root --hint-bios=hd0,gpt2 --hint-efi=hd0,gpt2 --hint-baremetal=ahci0,gpt2  3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c\n"
+	"\telse\n"
+	"\t  search --no-floppy --fs-uuid --set=root 3f1a9c2e-7b4d-4e8f-9a6c-1d2e3f4a5b6c\n"
+	"\tfi\n"
+	"\tknetbsd\t/boot/memtest86+.elf\n"
+	"}\n"
+	"### END /etc/grub.d/20_memtest86+ ###\n"
+	"\n"
+	"### BEGIN /etc/grub.d/30_os-prober ###\n"
+	"menuentry \"Windows 7 (loader) (on /dev/sda1)\" --class windows --class os {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ntfs\n"
+	"\tset root='(hd0,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 01CC8B6F6F1A0F10\n"
+	"\tchainloader +1\n"
+	"}\n"
+	"menuentry \"Windows XP Professional (on /dev/sdb1)\" --class windows --class os {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ntfs\n"
+	"\tset root='(hd1,msdos1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 4A7C2D7E7C2D6695\n"
+	"\tdrivemap -s (hd0) ${root}\n"
+	"\tchainloader +1\n"
+	"}\n"
+	"menuentry 'Windows Boot Manager (on /dev/nvme0n1p1)' --class windows --class os $menuentry_id_option 'osprober-efi-1CE5-7F28' {\n"
+	"\tinsmod part_gpt\n"
+	"\tinsmod fat\n"
+	"\tset root='hd0,gpt1'\n"
+	"\tif [ x$feature_platform_search_hint = xy ]; then\n"
+	"\t  search --no-floppy --fs-uuid --set=root --hint-bios=hd0,gpt1 --hint-efi=hd0,gpt1 --hint-baremetal=ahci0,gpt1  1CE5-7F28\n"
+	"\telse\n"
+	"\t  search --no-floppy --fs-uuid --set=root 1CE5-7F28\n"
+	"\tfi\n"
+	"\tchainloader /EFI/Microsoft/Boot/bootmgfw.efi\n"
+	"}\n"
+	"menuentry \"Linux Mint 13 Maya (13) (on /dev/sda6)\" --class gnu-linux --class gnu --class os {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos6)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 5d6e7f80-91a2-b3c4-d5e6-f708192a3b4c\n"
+	"\tlinux /boot/vmlinuz-3.2.0-23-generic root=UUID=5d6e7f80-91a2-b3c4-d5e6-f708192a3b4c ro quiet splash\n"
+	"\tinitrd /boot/initrd.img-3.2.0-23-generic\n"
+	"}\n"
+	"menuentry \"Fedora (3.3.4-5.fc17.x86_64) (on /dev/sda7)\" --class gnu-linux --class gnu --class os {\n"
+	"\tinsmod part_msdos\n"
+	"\tinsmod ext2\n"
+	"\tset root='(hd0,msdos7)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 6e7f8091-a2b3-c4d5-e6f7-08192a3b4c5d\n"
+	"\tlinux /vmlinuz-3.3.4-5.fc17.x86_64 root=/dev/mapper/vg_fedora-lv_root ro rd.lvm.lv=vg_fedora/lv_root rhgb quiet\n"
+	"\tinitrd /initramfs-3.3.4-5.fc17.x86_64.img\n"
+	"}\n"
+	"### END /etc/grub.d/30_os-prober ###\n"
+	"\n"
+	"### BEGIN /etc/grub.d/40_custom ###\n"
+	"menuentry \"Ubuntu 12.04 ISO\"{\n"
+	"\tset root='(hd0,1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 8e7d8f36-6a5c-4b2b-9a12-4e0b1f7c6a21\n"
+	"\tloopback loop \"/iso/ubuntu-12.04-desktop-i386.iso\"\n"
+	"\tlinux (loop)/casper/vmlinuz boot=casper iso-scan/filename=\"/iso/ubuntu-12.04-desktop-i386.iso\" locale=en_US.UTF-8 noprompt noeject\n"
+	"\tinitrd (loop)/casper/initrd.lz\n"
+	"}\n"
+	"menuentry \"Chainload sdb\"{\n"
+	"\tset root='(hd1,1)'\n"
+	"\tsearch --no-floppy --fs-uuid --set=root 4A7C2D7E7C2D6695\n"
+	"\tchainloader +1\n"
+	"}\n"
+	"### END /etc/grub.d/40_custom ###\n";
+
+#endif /* BENCHMARK_CONTENTPARSERCHECK_H_ */
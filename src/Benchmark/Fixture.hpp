@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef BENCHMARK_FIXTURE_H_
+#define BENCHMARK_FIXTURE_H_
+#include <string>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <sys/stat.h>
+#include "../config.hpp"
+#include "../lib/FileSystem.hpp"
+#include "../lib/Exception.hpp"
+
+/**
+ * synthetic configuration root: an /etc/grub.d directory with generated scripts,
+ * a grub-mkconfig stub and the boot/grub/grub.cfg it produces
+ */
+class Benchmark_Fixture
+{
+	public: struct Params {
+		int kernels;
+		int submenuDepth;
+		int osProberEntries;
+		int proxies;
+		int customEntries;
+
+		Params() : kernels(4), submenuDepth(1), osProberEntries(2), proxies(1), customEntries(2) {}
+	};
+
+	public: Params params;
+	public: std::string rootDir;
+	public: std::string proxyBinary;
+
+	public: Benchmark_Fixture(Params const& params, std::string const& proxyBinary = "") :
+		params(params), proxyBinary(proxyBinary)
+	{}
+
+	public: ~Benchmark_Fixture() {
+		this->remove();
+	}
+
+	public: void create() {
+		char dirTemplate[] = "/tmp/grub-customizer-benchmark-XXXXXX";
+		if (mkdtemp(dirTemplate) == NULL) {
+			throw FileSaveException("cannot create fixture directory", __FILE__, __LINE__);
+		}
+		this->rootDir = dirTemplate;
+
+		mkdir((this->rootDir + "/etc").c_str(), 0755);
+		mkdir(this->getCfgDir().c_str(), 0755);
+		mkdir((this->getCfgDir() + "/bin").c_str(), 0755);
+		mkdir((this->rootDir + "/boot").c_str(), 0755);
+		mkdir((this->rootDir + "/boot/grub").c_str(), 0755);
+		mkdir((this->rootDir + "/sbin").c_str(), 0755);
+
+		this->writeFile(this->getMkconfigStub(), this->buildMkconfigStub(), 0755);
+		this->writeFile(this->getCfgDir() + "/00_header", this->buildHeaderScript(), 0755);
+		this->writeFile(this->getCfgDir() + "/10_linux", this->buildScript(this->buildLinuxEntries()), 0755);
+		this->writeFile(this->getCfgDir() + "/40_custom", std::string(CUSTOM_SCRIPT_SHEBANG) + "\n" + CUSTOM_SCRIPT_PREFIX + "\n" + this->buildCustomEntries(), 0755);
+
+		std::string osProberScript = this->buildScript(this->buildOsProberEntries());
+		if (this->params.proxies > 0) {
+			mkdir((this->getCfgDir() + "/proxifiedScripts").c_str(), 0755);
+			this->writeFile(this->getCfgDir() + "/proxifiedScripts/os-prober", osProberScript, 0755);
+			for (int i = 0; i < this->params.proxies; i++) {
+				std::ostringstream nameStream;
+				nameStream << this->getCfgDir() << "/" << std::setw(2) << std::setfill('0') << (30 + i) << "_os-prober_proxy";
+				this->writeFile(nameStream.str(), this->buildProxyScript(i), 0755);
+			}
+		} else {
+			this->writeFile(this->getCfgDir() + "/30_os-prober", osProberScript, 0755);
+		}
+
+		if (this->proxyBinary != "") {
+			FileSystem().copy(this->proxyBinary, this->getCfgDir() + "/bin/grubcfg_proxy");
+			chmod((this->getCfgDir() + "/bin/grubcfg_proxy").c_str(), 0755);
+		} else {
+			this->writeFile(this->getCfgDir() + "/bin/grubcfg_proxy", "#!/bin/sh\ncat\n", 0755);
+		}
+
+		if (system((this->getMkconfigStub() + " -o '" + this->getOutputFile() + "'").c_str()) != 0) {
+			throw CmdExecException("failed generating the fixture grub.cfg", __FILE__, __LINE__);
+		}
+	}
+
+	public: void remove() {
+		if (this->rootDir != "") {
+			FileSystem().rmdirRecursive(this->rootDir);
+			this->rootDir = "";
+		}
+	}
+
+	public: std::string getCfgDir() const {
+		return this->rootDir + "/etc/grub.d";
+	}
+
+	public: std::string getOutputFile() const {
+		return this->rootDir + "/boot/grub/grub.cfg";
+	}
+
+	public: std::string getMkconfigStub() const {
+		return this->rootDir + "/sbin/grub-mkconfig";
+	}
+
+	/**
+	 * settings for Model_Env::setProperties - the fixture is addressed by absolute paths,
+	 * so the env must be used without cfg_dir_prefix
+	 */
+	public: std::map<std::string, std::string> getEnvProperties() const {
+		std::map<std::string, std::string> result;
+		result["MKCONFIG_CMD"] = this->getMkconfigStub();
+		result["INSTALL_CMD"] = "true";
+		result["MKFONT_CMD"] = "true";
+		result["MKDEVICEMAP_CMD"] = "true";
+		result["CFG_DIR"] = this->getCfgDir();
+		result["OUTPUT_DIR"] = this->rootDir + "/boot/grub";
+		result["OUTPUT_FILE"] = this->getOutputFile();
+		result["SETTINGS_FILE"] = this->rootDir + "/etc/default/grub";
+		result["DEVICEMAP_FILE"] = this->rootDir + "/boot/grub/device.map";
+		return result;
+	}
+
+	/**
+	 * number of menuentries in the generated grub.cfg (proxies may duplicate entries)
+	 */
+	public: int countGeneratedEntries() const {
+		std::ifstream file(this->getOutputFile().c_str());
+		int result = 0;
+		std::string row;
+		while (std::getline(file, row)) {
+			if (row.find("menuentry ") == row.find_first_not_of(" \t") && row.find("menuentry ") != std::string::npos) {
+				result++;
+			}
+		}
+		return result;
+	}
+
+	public: std::string getName() const {
+		std::ostringstream result;
+		result << "k" << this->params.kernels << "_d" << this->params.submenuDepth << "_o" << this->params.osProberEntries
+		       << "_p" << this->params.proxies << "_c" << this->params.customEntries;
+		return result.str();
+	}
+
+	private: void writeFile(std::string const& path, std::string const& content, mode_t mode) {
+		std::ofstream file(path.c_str());
+		if (!file) {
+			throw FileSaveException("cannot write fixture file " + path, __FILE__, __LINE__);
+		}
+		file << content;
+		file.close();
+		chmod(path.c_str(), mode);
+	}
+
+	/**
+	 * mimics grub-mkconfig: runs every executable file of the cfg dir, framed by BEGIN/END markers
+	 */
+	private: std::string buildMkconfigStub() const {
+		return
+			"#!/bin/sh\n"
+			"if [ \"$1\" = \"-o\" ]; then\n"
+			"\texec > \"$2.new\"\n"
+			"fi\n"
+			"for i in '" + this->getCfgDir() + "'/*; do\n"
+			"\tif [ -f \"$i\" ] && [ -x \"$i\" ]; then\n"
+			"\t\techo \"### BEGIN $i ###\"\n"
+			"\t\t\"$i\" || exit 1\n"
+			"\t\techo \"### END $i ###\"\n"
+			"\tfi\n"
+			"done\n"
+			"if [ \"$1\" = \"-o\" ]; then\n"
+			"\tmv \"$2.new\" \"$2\"\n"
+			"fi\n";
+	}
+
+	private: std::string buildScript(std::string const& output) const {
+		return "#!/bin/sh\ncat << 'EOF'\n" + output + "EOF\n";
+	}
+
+	private: std::string buildHeaderScript() const {
+		return this->buildScript(
+			"set default=\"0\"\n"
+			"insmod part_msdos\n"
+			"insmod ext2\n"
+			"set root='hd0,msdos1'\n"
+			"if loadfont /usr/share/grub/unicode.pf2 ; then\n"
+			"  set gfxmode=auto\n"
+			"  load_video\n"
+			"  insmod gfxterm\n"
+			"fi\n"
+			"terminal_output gfxterm\n"
+			"set timeout=10\n"
+		);
+	}
+
+	private: std::string buildUuid(int disk, int partition) const {
+		std::ostringstream result;
+		result << std::hex << std::setfill('0') << std::setw(8) << (0x1c2d3e4f + disk) << "-"
+		       << std::setw(4) << (0x1000 + partition) << "-4a5b-8c9d-0e1f2a3b4c5d";
+		return result.str();
+	}
+
+	private: std::string buildLinuxEntry(std::string const& title, std::string const& version, bool recovery) const {
+		std::string uuid = this->buildUuid(0, 1);
+		return
+			"menuentry '" + title + "' --class gnu-linux --class gnu --class os {\n"
+			"\trecordfail\n"
+			"\tload_video\n"
+			"\tinsmod gzio\n"
+			"\tset root='(hd0,1)'\n"
+			"\tsearch --no-floppy --fs-uuid --set=root " + uuid + "\n"
+			"\techo 'Loading Linux " + version + " ...'\n"
+			"\tlinux /boot/vmlinuz-" + version + " root=UUID=" + uuid + " ro " + (recovery ? "recovery nomodeset" : "quiet splash") + "\n"
+			"\techo 'Loading initial ramdisk ...'\n"
+			"\tinitrd /boot/initrd.img-" + version + "\n"
+			"}\n";
+	}
+
+	private: std::string buildLinuxEntries() const {
+		std::string result = this->buildLinuxEntry("GNU/Linux", "5.0.0-1-generic", false);
+		std::string kernelEntries;
+		for (int i = 0; i < this->params.kernels; i++) {
+			std::ostringstream version;
+			version << "5.0." << i << "-" << (i + 1) << "-generic";
+			kernelEntries += this->buildLinuxEntry("GNU/Linux, with Linux " + version.str(), version.str(), false);
+			kernelEntries += this->buildLinuxEntry("GNU/Linux, with Linux " + version.str() + " (recovery mode)", version.str(), true);
+		}
+		for (int depth = this->params.submenuDepth; depth > 0; depth--) {
+			std::ostringstream title;
+			title << "Advanced options for GNU/Linux";
+			if (depth > 1) {
+				title << " (level " << depth << ")";
+			}
+			kernelEntries = "submenu '" + title.str() + "' {\n" + kernelEntries + "}\n";
+		}
+		return result + kernelEntries;
+	}
+
+	private: std::string buildOsProberEntries() const {
+		std::string result;
+		for (int i = 0; i < this->params.osProberEntries; i++) {
+			std::ostringstream title, partition;
+			title << "Other OS " << i << " (on /dev/sdb" << (i + 1) << ")";
+			partition << (i + 1);
+			result +=
+				"menuentry '" + title.str() + "' --class windows --class os {\n"
+				"\tinsmod part_msdos\n"
+				"\tinsmod ntfs\n"
+				"\tset root='(hd1," + partition.str() + ")'\n"
+				"\tsearch --no-floppy --fs-uuid --set=root " + this->buildUuid(1, i + 1) + "\n"
+				"\tparttool ${root} hidden-\n"
+				"\tchainloader +1\n"
+				"}\n";
+		}
+		return result;
+	}
+
+	private: std::string buildCustomEntries() const {
+		std::string result;
+		for (int i = 0; i < this->params.customEntries; i++) {
+			std::ostringstream title, isoFile;
+			title << "Live ISO " << i;
+			isoFile << "/iso/live-" << i << ".iso";
+			result +=
+				"menuentry '" + title.str() + "' {\n"
+				"\tset root='(hd0,2)'\n"
+				"\tsearch --no-floppy --fs-uuid --set=root " + this->buildUuid(0, 2) + "\n"
+				"\tloopback loop " + isoFile.str() + "\n"
+				"\tlinux (loop)/casper/vmlinuz boot=casper iso-scan/filename=" + isoFile.str() + " noprompt noeject\n"
+				"\tinitrd (loop)/casper/initrd.lz\n"
+				"}\n";
+		}
+		return result;
+	}
+
+	/**
+	 * the first proxy shows everything, each further one exactly one os-prober entry
+	 */
+	private: std::string buildProxyScript(int proxyIndex) const {
+		std::string rules;
+		if (proxyIndex == 0 || this->params.osProberEntries == 0) {
+			rules = "+*\n";
+		} else {
+			std::ostringstream title;
+			title << "Other OS " << (proxyIndex % this->params.osProberEntries) << " (on /dev/sdb" << (proxyIndex % this->params.osProberEntries + 1) << ")";
+			rules = "+'" + title.str() + "'\n-*\n";
+		}
+		return
+			"#!/bin/sh\n#THIS IS A GRUB PROXY SCRIPT\n"
+			"'" + this->getCfgDir() + "/proxifiedScripts/os-prober' | " + this->getCfgDir() + "/bin/grubcfg_proxy \"" + rules + "\"";
+	}
+};
+
+#endif /* BENCHMARK_FIXTURE_H_ */
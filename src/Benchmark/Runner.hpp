@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef BENCHMARK_RUNNER_H_
+#define BENCHMARK_RUNNER_H_
+#include <string>
+#include <list>
+#include <functional>
+#include <chrono>
+#include <ostream>
+#include "../config.hpp"
+#include "AllocationCounter.hpp"
+#include "Fixture.hpp"
+
+struct Benchmark_Result {
+	std::string name;
+	std::string fixtureName;
+	Benchmark_Fixture::Params params;
+	int iterations;
+	int itemsPerIteration;
+	double seconds;
+	unsigned long allocations;
+	unsigned long allocatedBytes;
+	bool allocationsTracked; // false for measurements of external processes
+};
+
+class Benchmark_Runner
+{
+	public: int iterations;
+	public: std::list<Benchmark_Result> results;
+
+	public: Benchmark_Runner() : iterations(5) {}
+
+	/**
+	 * runs task this->iterations times, setUp is called before each iteration and isn't measured
+	 */
+	public: void run(
+		std::string const& name,
+		Benchmark_Fixture const& fixture,
+		int itemsPerIteration,
+		std::function<void ()> task,
+		std::function<void ()> setUp = nullptr,
+		bool allocationsTracked = true
+	) {
+		Benchmark_Result result;
+		result.name = name;
+		result.fixtureName = fixture.getName();
+		result.params = fixture.params;
+		result.iterations = this->iterations;
+		result.itemsPerIteration = itemsPerIteration;
+		result.seconds = 0;
+		result.allocations = 0;
+		result.allocatedBytes = 0;
+		result.allocationsTracked = allocationsTracked;
+
+		for (int i = 0; i < this->iterations; i++) {
+			if (setUp) {
+				setUp();
+			}
+			unsigned long allocationsBefore = Benchmark_AllocationCounter::count();
+			unsigned long bytesBefore = Benchmark_AllocationCounter::bytes();
+			auto start = std::chrono::steady_clock::now();
+
+			task();
+
+			auto end = std::chrono::steady_clock::now();
+			result.allocations += Benchmark_AllocationCounter::count() - allocationsBefore;
+			result.allocatedBytes += Benchmark_AllocationCounter::bytes() - bytesBefore;
+			result.seconds += std::chrono::duration<double>(end - start).count();
+		}
+		this->results.push_back(result);
+	}
+
+	public: void printJson(std::ostream& out) const {
+		out << "{\n";
+		out << "  \"version\": \"" << GC_VERSION << "\",\n";
+		out << "  \"results\": [";
+		for (auto iter = this->results.begin(); iter != this->results.end(); iter++) {
+			double secondsPerIteration = iter->seconds / iter->iterations;
+			out << (iter == this->results.begin() ? "\n" : ",\n");
+			out << "    {"
+			    << "\"name\": \"" << iter->name << "\", "
+			    << "\"fixture\": \"" << iter->fixtureName << "\", "
+			    << "\"kernels\": " << iter->params.kernels << ", "
+			    << "\"submenu_depth\": " << iter->params.submenuDepth << ", "
+			    << "\"os_prober_entries\": " << iter->params.osProberEntries << ", "
+			    << "\"proxies\": " << iter->params.proxies << ", "
+			    << "\"custom_entries\": " << iter->params.customEntries << ", "
+			    << "\"iterations\": " << iter->iterations << ", "
+			    << "\"items_per_iteration\": " << iter->itemsPerIteration << ", "
+			    << "\"seconds_per_iteration\": " << secondsPerIteration << ", "
+			    << "\"items_per_second\": " << (secondsPerIteration > 0 ? iter->itemsPerIteration / secondsPerIteration : 0) << ", ";
+			if (iter->allocationsTracked) {
+				out << "\"allocations_per_iteration\": " << iter->allocations / iter->iterations << ", "
+				    << "\"allocated_bytes_per_iteration\": " << iter->allocatedBytes / iter->iterations;
+			} else {
+				out << "\"allocations_per_iteration\": null, "
+				    << "\"allocated_bytes_per_iteration\": null";
+			}
+			out << "}";
+		}
+		out << "\n  ]\n";
+		out << "}\n";
+	}
+};
+
+#endif /* BENCHMARK_RUNNER_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef BENCHMARK_STDREGEX_H_
+#define BENCHMARK_STDREGEX_H_
+#include <regex>
+#include <map>
+#include <memory>
+#include "../lib/Regex.hpp"
+#include "../lib/Exception.hpp"
+#include "../lib/Helper.hpp"
+
+/**
+ * Regex engine based on std::regex - the benchmark is built without GLib, but needs
+ * the parser patterns for comparison. PCRE's "$" (end or before a final newline)
+ * is translated, the other constructs used by the patterns behave the same in ECMAScript.
+ */
+class Benchmark_StdRegex :
+	public Regex
+{
+	private: std::map<std::string, std::shared_ptr<std::regex> > compiledPatterns;
+
+	public: std::vector<std::string> match(
+		std::string const& pattern,
+		std::string const& str,
+		char const& escapeCharacter = '\0',
+		char const& replaceCharacter = '\0'
+	)
+	{
+		std::smatch matchResult;
+		std::string matchStr = escapeCharacter == '\0' ? str : Helper::str_replace_escape(str, escapeCharacter, replaceCharacter);
+		if (!std::regex_search(matchStr, matchResult, *this->getCompiledPattern(pattern))) {
+			throw RegExNotMatchedException("RegEx doesn't match", __FILE__, __LINE__);
+		}
+
+		// like PCRE: unmatched groups at the end aren't returned
+		size_t matchCount = matchResult.size();
+		while (matchCount > 1 && !matchResult[matchCount - 1].matched) {
+			matchCount--;
+		}
+		std::vector<std::string> result;
+		for (size_t i = 0; i < matchCount; i++) {
+			result.push_back(matchResult[i].matched ? str.substr(matchResult.position(i), matchResult.length(i)) : "");
+		}
+		return result;
+	}
+
+	public: std::string replace(
+		std::string const& pattern,
+		std::string const& str,
+		std::map<int, std::string> const& newValues,
+		char const& escapeCharacter = '\0',
+		char const& replaceCharacter = '\0'
+	)
+	{
+		std::smatch matchResult;
+		std::string matchStr = escapeCharacter == '\0' ? str : Helper::str_replace_escape(str, escapeCharacter, replaceCharacter);
+		if (!std::regex_search(matchStr, matchResult, *this->getCompiledPattern(pattern))) {
+			throw RegExNotMatchedException("RegEx doesn't match", __FILE__, __LINE__);
+		}
+
+		std::string result = str;
+		long offset = 0;
+		for (auto& newValue : newValues) {
+			if (size_t(newValue.first) < matchResult.size() && matchResult[newValue.first].matched) {
+				result.replace(matchResult.position(newValue.first) + offset, matchResult.length(newValue.first), newValue.second);
+				offset += long(newValue.second.size()) - matchResult.length(newValue.first);
+			}
+		}
+		return result;
+	}
+
+	public: void precompile(std::string const& pattern)
+	{
+		this->getCompiledPattern(pattern);
+	}
+
+	private: std::shared_ptr<std::regex> getCompiledPattern(std::string const& pattern)
+	{
+		if (this->compiledPatterns.find(pattern) == this->compiledPatterns.end()) {
+			this->compiledPatterns[pattern] = std::make_shared<std::regex>(this->translate(pattern));
+		}
+		return this->compiledPatterns[pattern];
+	}
+
+	private: std::string translate(std::string const& pattern)
+	{
+		std::string result;
+		bool inClass = false;
+		for (size_t i = 0; i < pattern.size(); i++) {
+			if (pattern[i] == '\\' && i + 1 < pattern.size()) {
+				result += pattern.substr(i++, 2);
+			} else if (pattern[i] == '[') {
+				inClass = true;
+				result += pattern[i];
+			} else if (pattern[i] == ']' && inClass) {
+				inClass = false;
+				result += pattern[i];
+			} else if (pattern[i] == '$' && !inClass) {
+				result += "(?=\\n?$)";
+			} else {
+				result += pattern[i];
+			}
+		}
+		return result;
+	}
+};
+
+#endif /* BENCHMARK_STDREGEX_H_ */
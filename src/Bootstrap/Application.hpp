@@ -22,13 +22,18 @@
 #include <functional>
 #include <list>
 #include <map>
+#include <string>
 #include "../lib/Exception.hpp"
+#include "../lib/Profiler.hpp"
 #include "../lib/Type.hpp"
 
 template <typename... Args>
 class Bootstrap_Application_Event
 {
 	private: std::list<std::function<void (Args...)>> eventHandlers;
+	private: std::string name;
+
+	public: explicit Bootstrap_Application_Event(std::string const& name) : name(name) {}
 
 	public: void addHandler(std::function<void (Args...)> eventHandler)
 	{
@@ -37,6 +42,7 @@ class Bootstrap_Application_Event
 
 	public: void exec(Args... args)
 	{
+		Profiler_Scope handlerTimer(this->name, "event");
 		for (auto func : this->eventHandlers) {
 			func(args...);
 		}
@@ -45,30 +51,30 @@ class Bootstrap_Application_Event
 
 class Bootstrap_Application_Object
 {
-	public: Bootstrap_Application_Event<Exception> onError;
-	public: Bootstrap_Application_Event<Exception> onThreadError;
+	public: Bootstrap_Application_Event<Exception> onError{"onError"};
+	public: Bootstrap_Application_Event<Exception> onThreadError{"onThreadError"};
 
-	public: Bootstrap_Application_Event<> onAboutDlgShowRequest;
-	public: Bootstrap_Application_Event<Rule*> onEntryEditorShowRequest;
-	public: Bootstrap_Application_Event<> onEnvEditorShowRequest;
-	public: Bootstrap_Application_Event<> onInstallerShowRequest;
-	public: Bootstrap_Application_Event<> onSettingsShowRequest;
+	public: Bootstrap_Application_Event<> onAboutDlgShowRequest{"onAboutDlgShowRequest"};
+	public: Bootstrap_Application_Event<Rule*> onEntryEditorShowRequest{"onEntryEditorShowRequest"};
+	public: Bootstrap_Application_Event<> onEnvEditorShowRequest{"onEnvEditorShowRequest"};
+	public: Bootstrap_Application_Event<> onInstallerShowRequest{"onInstallerShowRequest"};
+	public: Bootstrap_Application_Event<> onSettingsShowRequest{"onSettingsShowRequest"};
 
-	public: Bootstrap_Application_Event<> onListModelChange;
-	public: Bootstrap_Application_Event<bool> onEnvChange;
-	public: Bootstrap_Application_Event<> onListRelevantSettingChange;
+	public: Bootstrap_Application_Event<> onListModelChange{"onListModelChange"};
+	public: Bootstrap_Application_Event<bool> onEnvChange{"onEnvChange"};
+	public: Bootstrap_Application_Event<> onListRelevantSettingChange{"onListRelevantSettingChange"};
 
 	// param 1: the modified rule, param 2: whether it's a new rule
-	public: Bootstrap_Application_Event<Rule*, bool> onListRuleChange;
-	public: Bootstrap_Application_Event<> onTrashEntrySelection;
-	public: Bootstrap_Application_Event<> onEntrySelection;
-	public: Bootstrap_Application_Event<std::list<Rule*>> onEntryInsertionRequest; // TODO: do just selection - not the insertion itself
-	public: Bootstrap_Application_Event<std::list<Entry*>> onEntryRemove;
-
-	public: Bootstrap_Application_Event<> onInit;
-	public: Bootstrap_Application_Event<> onSettingModelChange;
-	public: Bootstrap_Application_Event<> onLoad; // loading finished (without preserving data)
-	public: Bootstrap_Application_Event<> onSave;
+	public: Bootstrap_Application_Event<Rule*, bool> onListRuleChange{"onListRuleChange"};
+	public: Bootstrap_Application_Event<> onTrashEntrySelection{"onTrashEntrySelection"};
+	public: Bootstrap_Application_Event<> onEntrySelection{"onEntrySelection"};
+	public: Bootstrap_Application_Event<std::list<Rule*>> onEntryInsertionRequest{"onEntryInsertionRequest"}; // TODO: do just selection - not the insertion itself
+	public: Bootstrap_Application_Event<std::list<Entry*>> onEntryRemove{"onEntryRemove"};
+
+	public: Bootstrap_Application_Event<> onInit{"onInit"};
+	public: Bootstrap_Application_Event<> onSettingModelChange{"onSettingModelChange"};
+	public: Bootstrap_Application_Event<> onLoad{"onLoad"}; // loading finished (without preserving data)
+	public: Bootstrap_Application_Event<> onSave{"onSave"};
 
 	public: std::map<ViewOption, bool> viewOptions;
 
@@ -40,6 +40,7 @@
 #include "../Model/ListCfg.hpp"
 #include "Helper/Thread.hpp"
 #include "Helper/RuleMover.hpp"
+#include "Helper/DeviceInfo.hpp"
 
 
 class EntryEditController :
@@ -53,11 +54,11 @@ class EntryEditController :
 	public Bootstrap_Application_Object_Connection,
 	public Controller_Helper_RuleMover_Connection
 {
-	private: std::shared_ptr<ContentParser> currentContentParser;
+	private: std::shared_ptr<ContentParser_Result const> currentParseResult;
 
 	public: EntryEditController() :
 		Controller_Common_ControllerAbstract("entry-edit"),
-		currentContentParser(NULL)
+		currentParseResult(nullptr)
 	{
 	}
 
@@ -158,11 +159,13 @@ class EntryEditController :
 			if (useOptionsAsSource) {
 				this->_updateSource(this->view->getOptions());
 			} else {
-				this->currentContentParser = this->contentParserFactory->create(this->view->getSourcecode());
-				this->view->setOptions(this->currentContentParser->getOptions());
+				this->currentParseResult = std::make_shared<ContentParser_Result const>(
+					this->contentParserFactory->parse(this->view->getSourcecode())
+				);
+				this->view->setOptions(this->currentParseResult->getOptions());
 			}
 
-			this->view->selectType(this->contentParserFactory->getNameByInstance(*this->currentContentParser));
+			this->view->selectType(this->currentParseResult->getType());
 
 			this->_validate();
 		} catch (ParserNotFoundException const& e) {
@@ -176,17 +179,18 @@ class EntryEditController :
 		this->logActionBegin("switch-type");
 		try {
 			if (newType != "" && newType != "[TEXT]") {
-				this->currentContentParser = this->contentParserFactory->createByName(newType);
-				this->currentContentParser->buildDefaultEntry();
+				this->currentParseResult = std::make_shared<ContentParser_Result const>(
+					this->contentParserFactory->createDefault(newType)
+				);
 				try {
-					this->view->setSourcecode(this->currentContentParser->buildSource());
+					this->view->setSourcecode(this->contentParserFactory->buildSource(*this->currentParseResult));
 					this->view->setApplyEnabled(true);
 				} catch (ParserException const& e) {
 					this->view->showSourceBuildError();
 					this->view->setApplyEnabled(false);
 				}
 
-				this->view->setOptions(this->currentContentParser->getOptions());
+				this->view->setOptions(this->currentParseResult->getOptions());
 			} else {
 				this->view->setOptions(std::map<std::string, std::string>());
 				this->view->setSourcecode("");
@@ -284,6 +288,7 @@ class EntryEditController :
 			}
 	
 			std::string newCode = this->view->getSourcecode();
+			Controller_Helper_DeviceInfo::invalidate(rule->dataSource->content);
 			rule->dataSource->content = newCode;
 			rule->dataSource->isModified = true;
 			rule->dataSource->type = type;
@@ -295,7 +300,7 @@ class EntryEditController :
 			this->applicationObject->onListModelChange.exec();
 			this->applicationObject->onListRuleChange.exec(rule.get(), false);
 	
-			this->currentContentParser = nullptr;
+			this->currentParseResult = nullptr;
 		} catch (Exception const& e) {
 			this->applicationObject->onError.exec(e);
 		}
@@ -338,19 +343,22 @@ class EntryEditController :
 
 	public: void _validate()
 	{
-		if (this->currentContentParser == NULL) {
+		if (this->currentParseResult == nullptr) {
 			return;
 		}
 
-		this->view->setErrors(this->currentContentParser->getErrors());
+		this->view->setErrors(this->contentParserFactory->getErrors(*this->currentParseResult));
 	}
 
 	public: void _updateSource(std::map<std::string, std::string> const& options)
 	{
-		assert(this->currentContentParser != NULL);
-		this->currentContentParser->setOptions(options);
+		assert(this->currentParseResult != nullptr);
+		// the template stays the parsed (or default) source, only the options change
+		this->currentParseResult = std::make_shared<ContentParser_Result const>(
+			this->currentParseResult->withOptions(options)
+		);
 		try {
-			this->view->setSourcecode(this->currentContentParser->buildSource());
+			this->view->setSourcecode(this->contentParserFactory->buildSource(*this->currentParseResult));
 			this->view->setApplyEnabled(true);
 		} catch (ParserException const& e) {
 			this->view->showSourceBuildError();
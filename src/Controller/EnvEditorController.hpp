@@ -213,7 +213,7 @@ class EnvEditorController :
 			if (saveConfig) {
 				this->env->save();
 			}
-			this->deviceMap->clearCache();
+			this->deviceMap->refresh();
 			this->applicationObject->onEnvChange.exec(isBurgMode);
 		} catch (Exception const& e) {
 			this->applicationObject->onError.exec(e);
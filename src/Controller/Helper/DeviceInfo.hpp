@@ -19,27 +19,108 @@
 #ifndef DEVICEINFO_H_
 #define DEVICEINFO_H_
 
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 #include "../../lib/ContentParserFactory.hpp"
 #include "../../Model/DeviceDataListInterface.hpp"
+#include "../../Model/DeviceMap.hpp"
 
+/**
+ * Parsing the entry content is done for every list row on every list update,
+ * so the results are cached by content digest. Edited entries get a new digest,
+ * a refreshed device list or device map drops the whole cache.
+ */
 class Controller_Helper_DeviceInfo
 {
+	private: struct CacheItem
+	{
+		std::string content;
+		std::map<std::string, std::string> options;
+	};
+
+	private: struct Cache
+	{
+		std::mutex mutex;
+		std::unordered_map<size_t, CacheItem> items;
+		Model_DeviceDataListInterface const* deviceDataList = nullptr;
+		unsigned int deviceDataListRevision = 0;
+		Model_DeviceMap const* deviceMap = nullptr;
+		unsigned int deviceMapRevision = 0;
+	};
+
+	// limits the memory used by contents of entries which have been edited or removed
+	private: static const size_t CACHE_SIZE_LIMIT = 4096;
+
+	private: static Cache& getCache()
+	{
+		static Cache cache;
+
+		return cache;
+	}
+
 	public: static std::map<std::string, std::string> fetch(
 		std::string const& menuEntryData,
-		ContentParserFactory& contentParserFactory,
+		ContentParserFactory const& contentParserFactory,
+		Model_DeviceDataListInterface const& deviceDataList,
+		Model_DeviceMap const& deviceMap
+	)
+	{
+		Cache& cache = getCache();
+		size_t digest = std::hash<std::string>()(menuEntryData);
+		{
+			std::lock_guard<std::mutex> lock(cache.mutex);
+			if (
+				cache.deviceDataList != &deviceDataList || cache.deviceDataListRevision != deviceDataList.getRevision() ||
+				cache.deviceMap != &deviceMap || cache.deviceMapRevision != deviceMap.getRevision()
+			) {
+				cache.items.clear();
+				cache.deviceDataList = &deviceDataList;
+				cache.deviceDataListRevision = deviceDataList.getRevision();
+				cache.deviceMap = &deviceMap;
+				cache.deviceMapRevision = deviceMap.getRevision();
+			}
+			auto itemIter = cache.items.find(digest);
+			if (itemIter != cache.items.end() && itemIter->second.content == menuEntryData) {
+				return itemIter->second.options;
+			}
+		}
+
+		std::map<std::string, std::string> options = parse(menuEntryData, contentParserFactory, deviceDataList);
+
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		if (cache.items.size() >= CACHE_SIZE_LIMIT) {
+			cache.items.clear();
+		}
+		CacheItem& item = cache.items[digest];
+		item.content = menuEntryData;
+		item.options = options;
+		return options;
+	}
+
+	// drops the cached info of the given entry content, to be called when an entry gets edited
+	public: static void invalidate(std::string const& menuEntryData)
+	{
+		Cache& cache = getCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		cache.items.erase(std::hash<std::string>()(menuEntryData));
+	}
+
+	private: static std::map<std::string, std::string> parse(
+		std::string const& menuEntryData,
+		ContentParserFactory const& contentParserFactory,
 		Model_DeviceDataListInterface const& deviceDataList
 	)
 	{
 		std::map<std::string, std::string> options;
 		try {
-			options = contentParserFactory.create(menuEntryData)->getOptions();
+			options = contentParserFactory.parse(menuEntryData).getOptions();
 			if (options.find("partition_uuid") != options.end()) {
 				// add device path
-				for (auto& item : deviceDataList) {
-					if (item.second.find("UUID") != item.second.end() && item.second.at("UUID") == options["partition_uuid"]) {
-						options["_deviceName"] = item.first;
-						break;
-					}
+				try {
+					options["_deviceName"] = deviceDataList.getDeviceByUuid(options["partition_uuid"]);
+				} catch (ItemNotFoundException const& e) {
+					// device not connected
 				}
 			}
 		} catch (ParserNotFoundException const& e) {
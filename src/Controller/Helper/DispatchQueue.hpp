@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef HELPER_DISPATCHQUEUE_H_INCLUDED
+#define HELPER_DISPATCHQUEUE_H_INCLUDED
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <string>
+#include <exception>
+#include "../../lib/Exception.hpp"
+
+/**
+ * functions waiting to be run by the main loop
+ *
+ * Pushing returns whether the main loop has to be woken up - that's only required
+ * once per batch. runAll() runs the whole batch, an exception thrown by one
+ * function is passed to onError and doesn't affect the other functions.
+ */
+class Controller_Helper_DispatchQueue
+{
+	private: struct Item
+	{
+		std::string key; // empty if not coalesced
+		std::function<void ()> function;
+	};
+
+	private: std::queue<Item> items;
+	private: std::set<std::string> queuedKeys;
+	private: bool wakeupPending = false;
+	private: std::mutex mutex;
+
+	/**
+	 * @param key skipped if a function using the same key is still waiting, empty = never skipped
+	 * @return whether the caller has to wake up the main loop
+	 */
+	public: bool push(std::string const& key, std::function<void ()> function)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (key != "" && !this->queuedKeys.insert(key).second) {
+			return false; // the queued call will do the same
+		}
+		this->items.push({key, function});
+
+		bool wakeupRequired = !this->wakeupPending;
+		this->wakeupPending = true;
+		return wakeupRequired;
+	}
+
+	public: void runAll(std::function<void (std::string const& message)> onError)
+	{
+		std::queue<Item> batch;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::swap(batch, this->items);
+			this->queuedKeys.clear(); // calls from now on must be queued again - the state may have changed meanwhile
+			this->wakeupPending = false;
+		}
+
+		for (; !batch.empty(); batch.pop()) {
+			try {
+				batch.front().function();
+			} catch (Exception const& e) {
+				onError(e.getMessage());
+			} catch (std::exception const& e) {
+				onError(e.what());
+			} catch (...) {
+				onError("unknown exception");
+			}
+		}
+	}
+};
+
+#endif /* HELPER_DISPATCHQUEUE_H_INCLUDED */
@@ -19,33 +19,47 @@
 #ifndef HELPER_GLIBTHREAD_H_INCLUDED
 #define HELPER_GLIBTHREAD_H_INCLUDED
 #include "Thread.hpp"
+#include "DispatchQueue.hpp"
+#include "WorkerPool.hpp"
 
 #include <functional>
-#include <queue>
+#include <memory>
+#include <thread>
 
 #include <glibmm/thread.h>
 #include <glibmm/dispatcher.h>
 
 #include <glibmm.h>
 
+/**
+ * Background functions are run by a fixed number of worker threads, which are started on demand.
+ * Dispatched functions are collected and run together on the next main loop wakeup.
+ */
 class Controller_Helper_GLibThread : public Controller_Helper_Thread
 {
-	private: std::queue<std::function<void ()>> dispatchQueue;
+	private: Controller_Helper_DispatchQueue dispatchQueue;
 	private: Glib::Dispatcher dispatcher; // the new general dispatcher
-	private: Glib::Threads::Mutex mutex;
 
-	public: Controller_Helper_GLibThread()
+	private: Controller_Helper_WorkerPool workerPool;
+
+	public: Controller_Helper_GLibThread() :
+		// tasks like loading the list run for a long time - keep some workers for the short ones
+		workerPool(std::max(4u, std::thread::hardware_concurrency()))
 	{
 		this->dispatcher.connect(sigc::mem_fun(this, &Controller_Helper_GLibThread::dispatcherCallback));
 	}
 
 	public: void runDispatched(std::function<void ()> function)
 	{
-		Glib::Threads::Mutex::Lock lock(this->mutex);
-		this->dispatchQueue.push(function);
-		lock.release();
+		this->runDispatchedCoalesced("", function);
+	}
 
-		this->dispatcher();
+	public: void runDispatchedCoalesced(std::string const& key, std::function<void ()> function)
+	{
+		// one wakeup for all functions queued until the callback runs
+		if (this->dispatchQueue.push(key, function)) {
+			this->dispatcher();
+		}
 	}
 
 	public: void runDelayed(std::function<void ()> function, int delayInMilliSec)
@@ -55,17 +69,20 @@ class Controller_Helper_GLibThread : public Controller_Helper_Thread
 
 	public: void runAsThread(std::function<void ()> function)
 	{
-		Glib::Thread::create(function, false);
+		// the worker may outlive this object
+		std::shared_ptr<Logger> logger = this->logger;
+		this->workerPool.run(function, [logger] (std::string const& message) {
+			if (logger) {
+				logger->log("background function failed: " + message, Logger::ERROR);
+			}
+		});
 	}
 
 	private: void dispatcherCallback()
 	{
-		Glib::Threads::Mutex::Lock lock(this->mutex);
-		auto func = this->dispatchQueue.front();
-		this->dispatchQueue.pop();
-		lock.release();
-
-		func();
+		this->dispatchQueue.runAll([this] (std::string const& message) {
+			this->log("dispatched function failed: " + message, Logger::ERROR);
+		});
 	}
 };
 
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef HELPER_TASKGRAPH_H_INCLUDED
+#define HELPER_TASKGRAPH_H_INCLUDED
+#include "Thread.hpp"
+#include "../../lib/Exception.hpp"
+
+#include <cassert>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Runs a set of tasks in background threads. Each task is started as soon as all of its
+ * dependencies have been finished, so independent tasks run in parallel.
+ * Create it as shared_ptr - running tasks keep the graph alive.
+ */
+class Controller_Helper_TaskGraph :
+	public std::enable_shared_from_this<Controller_Helper_TaskGraph>
+{
+	private: struct Task
+	{
+		std::string name;
+		std::list<std::string> dependencies;
+		std::function<void ()> function;
+		bool started = false;
+		bool finished = false;
+	};
+
+	private: std::shared_ptr<Controller_Helper_Thread> threadHelper;
+	private: std::list<Task> tasks;
+	private: std::mutex mutex;
+	private: std::function<void ()> onFinish;
+	private: std::function<void (Exception const& e)> onError;
+	private: size_t unfinishedTaskCount = 0;
+
+	public: Controller_Helper_TaskGraph(std::shared_ptr<Controller_Helper_Thread> threadHelper) :
+		threadHelper(threadHelper)
+	{}
+
+	// dependencies must have been added before
+	public: void addTask(std::string const& name, std::list<std::string> const& dependencies, std::function<void ()> function)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		for (auto& dependency : dependencies) {
+			assert(this->findTask(dependency) != nullptr);
+		}
+		Task task;
+		task.name = name;
+		task.dependencies = dependencies;
+		task.function = function;
+		this->tasks.push_back(task);
+	}
+
+	/**
+	 * starts the tasks. onFinish is dispatched to the main thread after all tasks have been finished.
+	 * onError is called inside of the worker thread when a task throws (exceptions other than Exception
+	 * are converted) - the depending tasks are run anyway.
+	 */
+	public: void run(std::function<void ()> onFinish, std::function<void (Exception const& e)> onError)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->onFinish = onFinish;
+		this->onError = onError;
+		this->unfinishedTaskCount = this->tasks.size();
+		if (this->unfinishedTaskCount == 0) {
+			this->threadHelper->runDispatched(this->onFinish);
+			return;
+		}
+		this->startReadyTasks();
+	}
+
+	// to be called while locked
+	private: void startReadyTasks()
+	{
+		std::shared_ptr<Controller_Helper_TaskGraph> self = this->shared_from_this();
+		for (auto& task : this->tasks) {
+			if (task.started || !this->dependenciesFinished(task)) {
+				continue;
+			}
+			task.started = true;
+			Task* taskPtr = &task;
+			this->threadHelper->runAsThread([self, taskPtr] {
+				self->execute(*taskPtr);
+			});
+		}
+	}
+
+	private: void execute(Task& task)
+	{
+		// the task must be marked as finished in any case - otherwise onFinish would never be called
+		try {
+			task.function();
+		} catch (Exception const& e) {
+			this->reportError(e);
+		} catch (std::exception const& e) {
+			this->reportError(Exception(task.name + " failed: " + e.what(), __FILE__, __LINE__));
+		} catch (...) {
+			this->reportError(Exception(task.name + " failed: unknown exception", __FILE__, __LINE__));
+		}
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		task.finished = true;
+		this->unfinishedTaskCount--;
+		if (this->unfinishedTaskCount == 0) {
+			this->threadHelper->runDispatched(this->onFinish);
+		} else {
+			this->startReadyTasks();
+		}
+	}
+
+	private: void reportError(Exception const& e)
+	{
+		try {
+			this->onError(e);
+		} catch (...) {
+			// nothing left to report to
+		}
+	}
+
+	private: bool dependenciesFinished(Task const& task)
+	{
+		for (auto& dependency : task.dependencies) {
+			if (!this->findTask(dependency)->finished) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	private: Task* findTask(std::string const& name)
+	{
+		for (auto& task : this->tasks) {
+			if (task.name == name) {
+				return &task;
+			}
+		}
+		return nullptr;
+	}
+};
+
+#endif /* HELPER_TASKGRAPH_H_INCLUDED */
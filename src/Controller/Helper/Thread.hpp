@@ -20,11 +20,14 @@
 #define HELPER_THREAD_H_INCLUDED
 #include "../../lib/Trait/LoggerAware.hpp"
 #include <functional>
+#include <string>
 
 class Controller_Helper_Thread : public Trait_LoggerAware
 {
 	public: virtual inline ~Controller_Helper_Thread() {};
 	public: virtual void runDispatched(std::function<void ()> function) = 0;
+	// like runDispatched, but skipped if a function using the same key is still waiting to be run
+	public: virtual void runDispatchedCoalesced(std::string const& key, std::function<void ()> function) = 0;
 	public: virtual void runDelayed(std::function<void ()> function, int delayInMilliSec) = 0;
 	public: virtual void runAsThread(std::function<void ()> function) = 0;
 };
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef HELPER_WORKERPOOL_H_INCLUDED
+#define HELPER_WORKERPOOL_H_INCLUDED
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include "../../lib/Exception.hpp"
+
+/**
+ * runs tasks using a limited number of worker threads, which are started on demand
+ *
+ * An exception thrown by a task is passed to the onError function given with the task,
+ * the worker continues with the next task.
+ */
+class Controller_Helper_WorkerPool
+{
+	private: struct Task
+	{
+		std::function<void ()> function;
+		std::function<void (std::string const& message)> onError;
+	};
+
+	// shared with the workers - they aren't joined, so they may outlive the pool on shutdown
+	private: struct State
+	{
+		std::mutex mutex;
+		std::condition_variable cond;
+		std::queue<Task> tasks;
+		unsigned int threadCount = 0;
+		unsigned int idleThreadCount = 0;
+		bool stopRequested = false;
+	};
+
+	private: std::shared_ptr<State> state;
+	private: unsigned int maxThreadCount;
+
+	public: Controller_Helper_WorkerPool(unsigned int maxThreadCount) :
+		state(std::make_shared<State>()),
+		maxThreadCount(maxThreadCount)
+	{}
+
+	// running tasks are finished, waiting ones are dropped
+	public: ~Controller_Helper_WorkerPool()
+	{
+		std::lock_guard<std::mutex> lock(this->state->mutex);
+		this->state->stopRequested = true;
+		this->state->cond.notify_all();
+	}
+
+	public: void run(std::function<void ()> function, std::function<void (std::string const& message)> onError)
+	{
+		std::shared_ptr<State> state = this->state;
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->tasks.push({function, onError});
+		if (state->idleThreadCount < state->tasks.size() && state->threadCount < this->maxThreadCount) {
+			state->threadCount++;
+			std::thread([state] {
+				Controller_Helper_WorkerPool::workerLoop(state);
+			}).detach();
+		} else {
+			state->cond.notify_one();
+		}
+	}
+
+	// number of running workers
+	public: unsigned int getThreadCount() const
+	{
+		std::lock_guard<std::mutex> lock(this->state->mutex);
+		return this->state->threadCount;
+	}
+
+	private: static void workerLoop(std::shared_ptr<State> state)
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		while (!state->stopRequested) {
+			if (state->tasks.empty()) {
+				state->idleThreadCount++;
+				state->cond.wait(lock);
+				state->idleThreadCount--;
+				continue;
+			}
+			Task task = state->tasks.front();
+			state->tasks.pop();
+			lock.unlock();
+
+			try {
+				task.function();
+			} catch (Exception const& e) {
+				Controller_Helper_WorkerPool::reportError(task, e.getMessage());
+			} catch (std::exception const& e) {
+				Controller_Helper_WorkerPool::reportError(task, e.what());
+			} catch (...) {
+				Controller_Helper_WorkerPool::reportError(task, "unknown exception");
+			}
+
+			lock.lock();
+		}
+		state->threadCount--;
+	}
+
+	private: static void reportError(Task const& task, std::string const& message)
+	{
+		try {
+			task.onError(message);
+		} catch (...) {
+			// nothing left to report to - the worker must survive
+		}
+	}
+};
+
+#endif /* HELPER_WORKERPOOL_H_INCLUDED */
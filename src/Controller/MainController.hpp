@@ -28,22 +28,26 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include "../config.hpp"
 
 #include "../Model/Env.hpp"
 
 #include "../Model/ListCfg.hpp"
 #include "../Model/DeviceDataList.hpp"
+#include "../Model/DeviceMap.hpp"
 #include "../lib/ContentParserFactory.hpp"
 
 #include "Common/ControllerAbstract.hpp"
 
 #include "../lib/Trait/LoggerAware.hpp"
 #include "../lib/Exception.hpp"
+#include "../lib/Profiler.hpp"
 #include "../Mapper/EntryName.hpp"
 #include "../Model/FbResolutionsGetter.hpp"
 #include "../View/Model/ListItem.hpp"
 #include "Helper/DeviceInfo.hpp"
+#include "Helper/TaskGraph.hpp"
 #include "Helper/Thread.hpp"
 
 /**
@@ -57,6 +61,7 @@ class MainController :
 	public Model_SettingsManagerData_Connection,
 	public Model_FbResolutionsGetter_Connection,
 	public Model_DeviceDataList_Connection,
+	public Model_DeviceMap_Connection,
 	public Model_MountTable_Connection,
 	public ContentParserFactory_Connection,
 	public Mapper_EntryName_Connection,
@@ -67,11 +72,15 @@ class MainController :
 {
 	private: std::shared_ptr<Model_SettingsManagerData> settingsOnDisk; //buffer for the existing settings
 	private: std::shared_ptr<Model_ListCfg> savedListCfg;
-	private: ContentParser* currentContentParser;
 
 	private: bool config_has_been_different_on_startup_but_unsaved;
 	private: bool is_loading;
+	private: bool reloadRequested; // set when reloading while another load is running
+	private: std::mutex loadStateMutex; // guards is_loading and reloadRequested - loads run on pool threads
 	private: CmdExecException thrownException; //to be used from the die() function
+	// results of the startup probing
+	private: bool isLiveCd;
+	private: std::list<Model_Env::Mode> availableModes;
 
 	public: void setSettingsBuffer(std::shared_ptr<Model_SettingsManagerData> settings)
 	{
@@ -160,6 +169,7 @@ class MainController :
 		using namespace std::placeholders;
 
 		this->grublistCfg->onLoadStateChange = std::bind(std::mem_fn(&MainController::syncLoadStateThreadedAction), this);
+		this->grublistCfg->onLoadStateChangeDeferred = std::bind(std::mem_fn(&MainController::syncLoadStateDeferredThreadedAction), this, _1);
 		this->grublistCfg->onSaveStateChange = std::bind(std::mem_fn(&MainController::syncSaveStateThreadedAction), this);
 	}
 
@@ -173,6 +183,7 @@ class MainController :
 			or !savedListCfg
 			or !fbResolutionsGetter
 			or !deviceDataList
+			or !deviceMap
 			or !mountTable
 			or !contentParserFactory
 			or !threadHelper
@@ -184,41 +195,76 @@ class MainController :
 
 		savedListCfg->verbose = false;
 
-		this->log("reading partition info…", Logger::EVENT);
-		FILE* blkidProc = popen("blkid", "r");
-		if (blkidProc){
-			deviceDataList->clear();
-			deviceDataList->loadData(blkidProc);
-			pclose(blkidProc);
-		}
-
-		mountTable->loadData("");
-		mountTable->loadData(PARTCHOOSER_MOUNTPOINT);
-
-
-		this->env->rootDeviceName = mountTable->getEntryByMountpoint("").device;
+		// the window is shown (locked) while the system is probed in background
+		this->view->setLockState(1|4|8);
+		this->view->show();
+		this->view->setStatusText(gettext("probing…"));
 
 		this->applicationObject->onInit.exec();
 
-		//dir_prefix may be set by partition chooser (if not, the root partition is used)
+		std::shared_ptr<Controller_Helper_TaskGraph> probing = std::make_shared<Controller_Helper_TaskGraph>(this->threadHelper);
+		probing->addTask("partition-info", {}, [this] {
+			this->log("reading partition info…", Logger::EVENT);
+			deviceDataList->clear();
+			if (!deviceDataList->loadFromSystem()) {
+				// blkid probes every device, which may take a while - only used if sysfs/udev data is missing
+				this->log("no partition info provided by udev - running blkid", Logger::INFO);
+				FILE* blkidProc = popen("blkid", "r");
+				if (blkidProc){
+					deviceDataList->loadData(blkidProc);
+					pclose(blkidProc);
+				}
+			}
+		});
+		probing->addTask("mount-table", {}, [this] {
+			mountTable->loadData("");
+			mountTable->loadData(PARTCHOOSER_MOUNTPOINT);
+
+			this->env->rootDeviceName = mountTable->getEntryByMountpoint("").device;
+		});
+		probing->addTask("bootloader-modes", {"mount-table"}, [this] {
+			//dir_prefix may be set by partition chooser (if not, the root partition is used)
+
+			this->log("Finding out if this is a live CD", Logger::EVENT);
+			//aufs is the virtual root fileSystem used by live cds
+			this->isLiveCd = mountTable->getEntryByMountpoint("").isLiveCdFs() && env->cfg_dir_prefix == "";
+			if (!this->isLiveCd) {
+				this->availableModes = this->env->getAvailableModes();
+			}
+		});
+		probing->run(
+			std::bind(std::mem_fn(&MainController::initProbingFinishedAction), this),
+			[this] (Exception const& e) {
+				this->applicationObject->onThreadError.exec(e);
+			}
+		);
+	}
 
-		this->log("Finding out if this is a live CD", Logger::EVENT);
-		//aufs is the virtual root fileSystem used by live cds
-		if (mountTable->getEntryByMountpoint("").isLiveCdFs() && env->cfg_dir_prefix == ""){
-			this->log("is live CD", Logger::INFO);
-			this->env->init(Model_Env::GRUB_MODE, "");
-			this->showEnvEditorAction();
-		} else {
-			this->log("running on an installed system", Logger::INFO);
-			std::list<Model_Env::Mode> modes = this->env->getAvailableModes();
-			if (modes.size() == 2) {
-				this->view->showBurgSwitcher();
-			} else if (modes.size() == 1) {
-				this->init(modes.front());
-			} else if (modes.size() == 0) {
+	// continues init() after all probing tasks are done
+	public: void initProbingFinishedAction()
+	{
+		this->logActionBegin("init-probing-finished");
+		try {
+			this->view->setStatusText("");
+			if (this->isLiveCd){
+				this->log("is live CD", Logger::INFO);
+				this->env->init(Model_Env::GRUB_MODE, "");
 				this->showEnvEditorAction();
+			} else {
+				this->log("running on an installed system", Logger::INFO);
+				if (this->availableModes.size() == 2) {
+					this->view->hide(); // cancelling the switcher quits the application only if the main window is hidden
+					this->view->showBurgSwitcher();
+				} else if (this->availableModes.size() == 1) {
+					this->init(this->availableModes.front());
+				} else if (this->availableModes.size() == 0) {
+					this->showEnvEditorAction();
+				}
 			}
+		} catch (Exception const& e) {
+			this->applicationObject->onError.exec(e);
 		}
+		this->logActionEnd();
 	}
 
 	public: void init(Model_Env::Mode mode, bool initEnv = true)
@@ -233,14 +279,24 @@ class MainController :
 		this->view->hideBurgSwitcher();
 		this->view->hideScriptUpdateInfo();
 
-		this->log("Checking if the config directory is clean", Logger::EVENT);
-		if (this->grublistCfg->cfgDirIsClean() == false) {
-			this->log("cleaning up config dir", Logger::IMPORTANT_EVENT);
-			this->grublistCfg->cleanupCfgDir();
-		}
-
-		this->log("loading configuration", Logger::IMPORTANT_EVENT);
-		this->threadHelper->runAsThread(std::bind(std::mem_fn(&MainController::loadThreadedAction), this, false));
+		std::shared_ptr<Controller_Helper_TaskGraph> loading = std::make_shared<Controller_Helper_TaskGraph>(this->threadHelper);
+		loading->addTask("cleanup-cfg-dir", {}, [this] {
+			this->log("Checking if the config directory is clean", Logger::EVENT);
+			if (this->grublistCfg->cfgDirIsClean() == false) {
+				this->log("cleaning up config dir", Logger::IMPORTANT_EVENT);
+				this->grublistCfg->cleanupCfgDir();
+			}
+		});
+		loading->addTask("load", {"cleanup-cfg-dir"}, [this] {
+			this->log("loading configuration", Logger::IMPORTANT_EVENT);
+			this->loadThreadedAction(false);
+		});
+		loading->run(
+			[] {},
+			[this] (Exception const& e) {
+				this->applicationObject->onThreadError.exec(e);
+			}
+		);
 	}
 
 	public: void initAction()
@@ -318,11 +374,26 @@ class MainController :
 	{
 		this->logActionBeginThreaded("load-threaded");
 		try {
-			if (!is_loading){ //allow only one load thread at the same time!
+			bool startLoad = false;
+			{
+				std::lock_guard<std::mutex> lock(this->loadStateMutex);
+				if (!this->is_loading) { //allow only one load thread at the same time!
+					this->is_loading = true;
+					startLoad = true;
+				} else if (preserveConfig) {
+					// the running load may hang (e.g. at os-prober) - kill it and load again when it's stopped
+					this->reloadRequested = true;
+					this->grublistCfg->cancelThreads();
+				}
+			}
+			if (startLoad){
 				this->log(std::string("loading - preserveConfig: ") + (preserveConfig ? "yes" : "no"), Logger::IMPORTANT_EVENT);
-				is_loading = true;
+				this->grublistCfg->cancelThreadsRequested = false; // a previous cancel request must not affect this load
 				this->env->activeThreadCount++;
 
+				// picks up partitions added or removed since the last load
+				this->deviceMap->refreshIfChanged();
+
 				try {
 					this->view->setOptions(this->env->loadViewOptions());
 				} catch (FileReadException e) {
@@ -370,7 +441,19 @@ class MainController :
 					this->settingsOnDisk->save();
 				}
 				this->env->activeThreadCount--;
-				this->is_loading = false;
+				bool restart = false;
+				{
+					std::lock_guard<std::mutex> lock(this->loadStateMutex);
+					restart = this->reloadRequested && !this->env->quit_requested;
+					this->reloadRequested = false;
+					this->is_loading = false;
+				}
+				if (restart) {
+					this->log("restarting the cancelled load", Logger::IMPORTANT_EVENT);
+					this->threadHelper->runAsThread(std::bind(std::mem_fn(&MainController::loadThreadedAction), this, true));
+				}
+			} else if (preserveConfig) {
+				this->log("cancelled the running load to reload", Logger::WARNING);
 			} else {
 				this->log("ignoring load request (only one load thread allowed at the same time)", Logger::WARNING);
 			}
@@ -436,8 +519,9 @@ class MainController :
 		Controller_Common_ControllerAbstract("main"),
 		config_has_been_different_on_startup_but_unsaved(false),
 		is_loading(false),
-		currentContentParser(NULL),
-		thrownException("")
+		reloadRequested(false),
+		thrownException(""),
+		isLiveCd(false)
 	{
 	}
 
@@ -511,7 +595,11 @@ class MainController :
 	{
 		this->logActionBegin("die");
 		try {
-			this->is_loading = false;
+			{
+				std::lock_guard<std::mutex> lock(this->loadStateMutex);
+				this->is_loading = false;
+				this->reloadRequested = false;
+			}
 			this->env->activeThreadCount = 0;
 			bool showEnvSettings = false;
 			if (this->thrownException){
@@ -530,7 +618,8 @@ class MainController :
 
 	public: void updateList()
 	{
-		this->view->clear();
+		Profiler_Scope updateListTimer("updateList", "MainController");
+		this->view->beginListUpdate();
 
 		for (auto& proxy : this->grublistCfg->proxies){
 			std::string name = proxy->getScriptName();
@@ -547,6 +636,7 @@ class MainController :
 				}
 			}
 		}
+		this->view->endListUpdate();
 	}
 
 	public: void updateTrashView()
@@ -770,7 +860,21 @@ class MainController :
 	{
 		this->logActionBeginThreaded("sync-load-state-threaded");
 		try {
-			this->threadHelper->runDispatched(std::bind(std::mem_fn(&MainController::syncLoadStateAction), this));
+			this->threadHelper->runDispatchedCoalesced("sync-load-state", std::bind(std::mem_fn(&MainController::syncLoadStateAction), this));
+		} catch (Exception const& e) {
+			this->applicationObject->onThreadError.exec(e);
+		}
+		this->logActionEndThreaded();
+	}
+
+	// shows a rate-limited load state change later unless another one is shown meanwhile
+	public: void syncLoadStateDeferredThreadedAction(int delayInMilliSec)
+	{
+		this->logActionBeginThreaded("sync-load-state-deferred-threaded");
+		try {
+			this->threadHelper->runDispatched([this, delayInMilliSec] {
+				this->threadHelper->runDelayed(std::bind(std::mem_fn(&MainController::syncDeferredLoadStateAction), this), delayInMilliSec);
+			});
 		} catch (Exception const& e) {
 			this->applicationObject->onThreadError.exec(e);
 		}
@@ -781,7 +885,7 @@ class MainController :
 	{
 		this->logActionBeginThreaded("sync-save-state-threaded");
 		try {
-			this->threadHelper->runDispatched(std::bind(std::mem_fn(&MainController::syncSaveStateAction), this));
+			this->threadHelper->runDispatchedCoalesced("sync-save-state", std::bind(std::mem_fn(&MainController::syncSaveStateAction), this));
 		} catch (Exception const& e) {
 			this->applicationObject->onThreadError.exec(e);
 		}
@@ -827,16 +931,22 @@ class MainController :
 		try {
 			this->log("running MainControllerImpl::syncListView_load", Logger::INFO);
 			this->view->setLockState(1|4);
-			double progress = this->grublistCfg->getProgress();
+			auto snapshot = this->grublistCfg->getProgressSnapshot();
+			double progress = snapshot->progress;
 			if (progress != 1) {
 				this->view->setProgress(progress);
-				this->view->setStatusText(this->grublistCfg->getProgress_name(), this->grublistCfg->getProgress_pos(), this->grublistCfg->getProgress_max());
+				this->view->setStatusText(snapshot->name, snapshot->pos, snapshot->max);
 			} else {
 				if (this->env->quit_requested) {
 					this->applicationObject->shutdown();
 				}
 				this->view->hideProgressBar();
-				this->view->setStatusText("");
+				auto slowestScript = this->grublistCfg->profileScripts ? this->grublistCfg->scriptProfile.getSlowest() : NULL;
+				if (slowestScript) {
+					this->view->showScriptProfile(slowestScript->scriptName, slowestScript->wallTime, this->grublistCfg->scriptProfile.getTotalWallTime());
+				} else {
+					this->view->setStatusText("");
+				}
 			}
 
 			if (progress == 1 && this->grublistCfg->hasScriptUpdates()) {
@@ -845,10 +955,17 @@ class MainController :
 				this->view->showScriptUpdateInfo();
 			}
 
-			//if grubConfig is locked, it will be cancelled as early as possible
-			if (this->grublistCfg->lock_if_free()) {
-				this->updateList();
-				this->grublistCfg->unlock();
+			// don't block the main loop while the loader modifies the list - retry later instead
+			if (this->grublistCfg->lockShared_if_free()) {
+				try {
+					this->updateList();
+				} catch (...) {
+					this->grublistCfg->unlockShared();
+					throw;
+				}
+				this->grublistCfg->unlockShared();
+			} else {
+				this->grublistCfg->deferLoadStateChange();
 			}
 
 			if (progress == 1){
@@ -863,6 +980,19 @@ class MainController :
 		this->logActionEnd();
 	}
 
+	public: void syncDeferredLoadStateAction()
+	{
+		this->logActionBegin("sync-deferred-load-state");
+		try {
+			if (this->grublistCfg->takeDeferredLoadStateChange()) {
+				this->syncLoadStateAction();
+			}
+		} catch (Exception const& e) {
+			this->applicationObject->onError.exec(e);
+		}
+		this->logActionEnd();
+	}
+
 	public: void showSettingsAction()
 	{
 		this->logActionBegin("show-settings");
@@ -1035,7 +1165,7 @@ class MainController :
 			// parse content to show additional informations
 			std::map<std::string, std::string> options;
 			if (rule->dataSource) {
-				options = Controller_Helper_DeviceInfo::fetch(rule->dataSource->content, *this->contentParserFactory, *deviceDataList);
+				options = Controller_Helper_DeviceInfo::fetch(rule->dataSource->content, *this->contentParserFactory, *deviceDataList, *this->deviceMap);
 			}
 
 			auto proxy = this->grublistCfg->proxies.getProxyByRule(rule);
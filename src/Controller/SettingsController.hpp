@@ -167,7 +167,7 @@ class SettingsController :
 	{
 		this->logActionBeginThreaded("update-resolutionlist-threaded");
 		try {
-			this->threadHelper->runDispatched(std::bind(std::mem_fn(&SettingsController::updateResolutionlistAction), this));
+			this->threadHelper->runDispatchedCoalesced("update-resolutionlist", std::bind(std::mem_fn(&SettingsController::updateResolutionlistAction), this));
 		} catch (Exception const& e) {
 			this->applicationObject->onThreadError.exec(e);
 		}
@@ -39,6 +39,7 @@
 #include "Common/ControllerAbstract.hpp"
 
 #include "../Model/DeviceDataListInterface.hpp"
+#include "../Model/DeviceMap.hpp"
 #include "../lib/ContentParserFactory.hpp"
 #include "Helper/DeviceInfo.hpp"
 
@@ -48,6 +49,7 @@ class TrashController :
 	public Model_ListCfg_Connection,
 	public Mapper_EntryName_Connection,
 	public Model_DeviceDataListInterface_Connection,
+	public Model_DeviceMap_Connection,
 	public ContentParserFactory_Connection,
 	public Model_Env_Connection,
 	public Bootstrap_Application_Object_Connection
@@ -172,6 +174,7 @@ class TrashController :
 	{
 		assert(this->contentParserFactory != nullptr);
 		assert(this->deviceDataList != nullptr);
+		assert(this->deviceMap != nullptr);
 
 		this->view->clear();
 
@@ -205,7 +208,8 @@ class TrashController :
 				listItem.options = Controller_Helper_DeviceInfo::fetch(
 					rule->dataSource->content,
 					*this->contentParserFactory,
-					*this->deviceDataList
+					*this->deviceDataList,
+					*this->deviceMap
 				);
 			}
 
@@ -21,10 +21,18 @@
 #include <map>
 #include <cstdio>
 #include <string>
+#include <fstream>
+#include <climits>
+#include <cctype>
+#include <dirent.h>
+#include <unistd.h>
 #include "../Model/DeviceDataListInterface.hpp"
 #include "../lib/Trait/LoggerAware.hpp"
 
 class Model_DeviceDataList : public Model_DeviceDataListInterface, public Trait_LoggerAware {
+	// secondary indexes - rebuilt whenever the data is (re)loaded
+	private: std::map<std::string, std::string> devicesByUuid;
+	private: std::map<std::string, std::string> devicesByLabel;
 public:
 	Model_DeviceDataList(FILE* blkidOutput){
 		loadData(blkidOutput);
@@ -33,6 +41,7 @@ public:
 	Model_DeviceDataList() {}
 
 	void loadData(FILE* blkidOutput) {
+		this->revision++;
 		std::string deviceName, attributeName;
 		bool inAttributeValue = false;
 		bool deviceNameIsComplete = false, attributeNameIsComplete = false;
@@ -67,19 +76,146 @@ public:
 				}
 			}
 		}
+		this->rebuildIndexes();
+	}
+
+	/**
+	 * reads the block devices known by the kernel (rootDir/sys/class/block) and the identifiers
+	 * provided by udev (rootDir/dev/disk/by-*, filesystem types from rootDir/run/udev/data).
+	 * Other than blkid this doesn't probe the devices, so it doesn't have to wait for slow disks.
+	 * Returns false if no device information has been found - blkid should be used then.
+	 */
+	bool loadFromSystem(std::string const& rootDir = "") {
+		this->revision++;
+		size_t previousSize = this->size();
+
+		// device -> major:minor
+		std::map<std::string, std::string> deviceNumbers;
+		std::string blockDir = rootDir + "/sys/class/block";
+		DIR* dir = opendir(blockDir.c_str());
+		if (dir) {
+			struct dirent* entry;
+			while ((entry = readdir(dir))) {
+				if (entry->d_name[0] == '.') {
+					continue;
+				}
+				std::string deviceNumber = this->readFirstLine(blockDir + "/" + entry->d_name + "/dev");
+				if (deviceNumber != "") {
+					deviceNumbers[std::string("/dev/") + entry->d_name] = deviceNumber;
+				}
+			}
+			closedir(dir);
+		}
+
+		this->loadLinks(rootDir + "/dev/disk/by-uuid", "UUID");
+		this->loadLinks(rootDir + "/dev/disk/by-label", "LABEL");
+		this->loadLinks(rootDir + "/dev/disk/by-partuuid", "PARTUUID");
+
+		for (std::map<std::string, std::map<std::string, std::string> >::iterator iter = this->begin(); iter != this->end(); iter++) {
+			if (deviceNumbers.find(iter->first) == deviceNumbers.end()) {
+				continue;
+			}
+			std::string fsType = this->readUdevProperty(rootDir + "/run/udev/data/b" + deviceNumbers[iter->first], "ID_FS_TYPE");
+			if (fsType != "") {
+				iter->second["TYPE"] = fsType;
+			}
+		}
+
+		this->rebuildIndexes();
+		this->log("found " + std::to_string(this->size() - previousSize) + " devices in " + (rootDir == "" ? "/" : rootDir), Logger::INFO);
+		return this->size() > previousSize;
 	}
 
 	void clear() {
+		this->revision++;
 		this->std::map<std::string, std::map<std::string, std::string> >::clear();
+		this->rebuildIndexes();
 	}
 
 	std::string getDeviceByUuid(std::string const& uuid) const {
+		std::map<std::string, std::string>::const_iterator deviceIter = this->devicesByUuid.find(uuid);
+		if (deviceIter == this->devicesByUuid.end()) {
+			throw ItemNotFoundException("no device found by uuid " + uuid, __FILE__, __LINE__);
+		}
+		return deviceIter->second;
+	}
+
+	std::string getDeviceByLabel(std::string const& label) const {
+		std::map<std::string, std::string>::const_iterator deviceIter = this->devicesByLabel.find(label);
+		if (deviceIter == this->devicesByLabel.end()) {
+			throw ItemNotFoundException("no device found by label " + label, __FILE__, __LINE__);
+		}
+		return deviceIter->second;
+	}
+
+	private: void rebuildIndexes() {
+		this->devicesByUuid.clear();
+		this->devicesByLabel.clear();
+		// insert doesn't overwrite, so the first device wins like in a linear search
 		for (std::map<std::string, std::map<std::string, std::string> >::const_iterator iter = this->begin(); iter != this->end(); iter++) {
-			if (iter->second.find("UUID") != iter->second.end() && iter->second.at("UUID") == uuid) {
-				return iter->first;
+			if (iter->second.find("UUID") != iter->second.end()) {
+				this->devicesByUuid.insert(std::make_pair(iter->second.at("UUID"), iter->first));
+			}
+			if (iter->second.find("LABEL") != iter->second.end()) {
+				this->devicesByLabel.insert(std::make_pair(iter->second.at("LABEL"), iter->first));
+			}
+		}
+	}
+
+	// adds the names of the links in the given directory as attribute of the devices they point to
+	private: void loadLinks(std::string const& linkDir, std::string const& attributeName) {
+		DIR* dir = opendir(linkDir.c_str());
+		if (!dir) {
+			return;
+		}
+		char targetBuf[PATH_MAX];
+		struct dirent* entry;
+		while ((entry = readdir(dir))) {
+			if (entry->d_name[0] == '.') {
+				continue;
+			}
+			int size = readlinkat(dirfd(dir), entry->d_name, targetBuf, sizeof(targetBuf));
+			if (size == -1) {
+				continue;
+			}
+			std::string target(targetBuf, size);
+			(*this)["/dev/" + target.substr(target.find_last_of('/') + 1)][attributeName] = this->decodeLinkName(entry->d_name);
+		}
+		closedir(dir);
+	}
+
+	// udev escapes unsafe characters of link names as \xNN
+	private: std::string decodeLinkName(std::string const& linkName) const {
+		std::string result;
+		for (size_t pos = 0; pos < linkName.size(); pos++) {
+			if (linkName.compare(pos, 2, "\\x") == 0 && pos + 3 < linkName.size()
+				&& isxdigit(linkName[pos + 2]) && isxdigit(linkName[pos + 3])) {
+				result += (char) std::stoi(linkName.substr(pos + 2, 2), nullptr, 16);
+				pos += 3;
+			} else {
+				result += linkName[pos];
 			}
 		}
-		throw ItemNotFoundException("no device found by uuid " + uuid, __FILE__, __LINE__);
+		return result;
+	}
+
+	private: std::string readUdevProperty(std::string const& dataFile, std::string const& name) const {
+		std::ifstream file(dataFile.c_str());
+		std::string prefix = "E:" + name + "=";
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.compare(0, prefix.size(), prefix) == 0) {
+				return line.substr(prefix.size());
+			}
+		}
+		return "";
+	}
+
+	private: std::string readFirstLine(std::string const& path) const {
+		std::ifstream file(path.c_str());
+		std::string line;
+		std::getline(file, line);
+		return line;
 	}
 
 };
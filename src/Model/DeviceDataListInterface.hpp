@@ -23,11 +23,21 @@
 #include <memory>
 
 class Model_DeviceDataListInterface : public std::map<std::string, std::map<std::string, std::string> > {
+protected:
+	unsigned int revision = 0;
 public:
 	virtual inline ~Model_DeviceDataListInterface() {};
 
 	virtual void loadData(FILE* blkidOutput)=0;
+	virtual bool loadFromSystem(std::string const& rootDir = "")=0;
 	virtual void clear()=0;
+	// throws ItemNotFoundException if there's no device having the given uuid
+	virtual std::string getDeviceByUuid(std::string const& uuid) const=0;
+
+	// changes whenever the device data is reloaded - allows caching of derived data
+	unsigned int getRevision() const {
+		return this->revision;
+	}
 };
 
 class Model_DeviceDataListInterface_Connection
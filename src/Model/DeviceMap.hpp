@@ -20,9 +20,16 @@
 #define GRUBDEVICEMAP_H_
 #include "../lib/Regex.hpp"
 #include <map>
+#include <mutex>
+#include <atomic>
 #include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <memory>
 #include "Env.hpp"
 #include "SmartFileHandle.hpp"
+#include "../lib/Trait/LoggerAware.hpp"
 
 struct Model_DeviceMap_PartitionIndex {
 	std::string hddNum, partNum;
@@ -30,9 +37,20 @@ struct Model_DeviceMap_PartitionIndex {
 
 class Model_DeviceMap :
 	public Model_Env_Connection,
-	public Regex_RegexConnection
+	public Regex_RegexConnection,
+	public Trait_LoggerAware
 {
-	mutable std::map<std::string, Model_DeviceMap_PartitionIndex> _cache;
+	private: struct Index {
+		std::map<std::string, std::string> diskNums; // disk device name (like sda) -> grub disk number
+		std::map<std::string, std::string> partitionDevices; // partition uuid -> target of /dev/disk/by-uuid link
+		time_t uuidDirModificationTime = 0;
+	};
+
+	// replaced as a whole - lookups keep using the index they got, so no lock is required while reading it
+	private: mutable std::shared_ptr<Index const> index;
+	private: mutable std::mutex indexMutex;
+	// increased whenever the index gets dropped - allows callers to detect outdated lookup results
+	private: std::atomic<unsigned int> revision{0};
 public:
 	Model_SmartFileHandle getFileHandle() const {
 		Model_SmartFileHandle result;
@@ -76,59 +94,123 @@ public:
 	}
 
 	Model_DeviceMap_PartitionIndex getHarddriveIndexByPartitionUuid(std::string partitionUuid) const {
-		if (this->_cache.find(partitionUuid) != this->_cache.end()) {
-			return this->_cache[partitionUuid];
-		}
-	
-		Model_DeviceMap_PartitionIndex result;
-		char deviceBuf[101];
-		int size = readlink((this->env->cfg_dir_prefix + "/dev/disk/by-uuid/" + partitionUuid).c_str(), deviceBuf, 100);
-		if (size == -1) { //if this didn't work, try to convert the uuid to uppercase
+		std::shared_ptr<Index const> index = this->getIndex();
+
+		std::map<std::string, std::string>::const_iterator deviceIter = index->partitionDevices.find(partitionUuid);
+		if (deviceIter == index->partitionDevices.end()) { //if this didn't work, try to convert the uuid to uppercase
 			for (std::string::iterator iter = partitionUuid.begin(); iter != partitionUuid.end(); iter++)
 				*iter = std::toupper(*iter);
-			size = readlink((this->env->cfg_dir_prefix + "/dev/disk/by-uuid/" + partitionUuid).c_str(), deviceBuf, 100);
+			deviceIter = index->partitionDevices.find(partitionUuid);
 		}
-		if (size == -1) {
-			return result; //abort with empty result
+		if (deviceIter == index->partitionDevices.end()) {
+			return Model_DeviceMap_PartitionIndex(); //abort with empty result
 		}
-	
-		deviceBuf[size] = '\0';
-	
-		std::vector<std::string> regexResult = this->regexEngine->match("([^/.0-9]+)([0-9]+)$", deviceBuf);
-		result.partNum = regexResult[2];
-	
-		std::string diskDevice = regexResult[1];
-	
-		Model_SmartFileHandle handle = this->getFileHandle();
-	
+
+		std::vector<std::string> regexResult;
 		try {
-			while (result.hddNum == "") {
-				std::string row = handle.getRow();
-				std::vector<std::string> rowMatch = this->regexEngine->match("^\\(hd([0-9]+)\\)[\t ]*(.*)$", row);
-				std::string diskFile = rowMatch[2];
-	
-				int size = readlink(diskFile.c_str(), deviceBuf, 100); // if this is a link, follow it
-				if (size != -1) {
-					diskFile = std::string(deviceBuf, size);
+			regexResult = this->regexEngine->match("([^/.0-9]+)([0-9]+)$", deviceIter->second);
+		} catch (RegExNotMatchedException const& e) {
+			return Model_DeviceMap_PartitionIndex(); // not a numbered partition (e.g. a filesystem on a whole disk)
+		}
+
+		Model_DeviceMap_PartitionIndex result;
+		result.partNum = regexResult[2];
+
+		std::map<std::string, std::string>::const_iterator diskIter = index->diskNums.find(regexResult[1]);
+		if (diskIter != index->diskNums.end()) {
+			result.hddNum = diskIter->second;
+		}
+		return result;
+	}
+
+	// drops the index, it will be rebuilt on next use - to be called when the device map configuration changes
+	void refresh() {
+		std::lock_guard<std::mutex> lock(this->indexMutex);
+		this->index = nullptr;
+		this->revision++;
+	}
+
+	// refreshes the index if partitions have been added or removed since it has been built
+	void refreshIfChanged() {
+		std::lock_guard<std::mutex> lock(this->indexMutex);
+		if (this->index && this->index->uuidDirModificationTime != this->getUuidDirModificationTime()) {
+			this->log("partitions changed - reloading device map", Logger::INFO);
+			this->index = nullptr;
+			this->revision++;
+		}
+	}
+
+	unsigned int getRevision() const {
+		return this->revision;
+	}
+
+	private: std::shared_ptr<Index const> getIndex() const {
+		std::lock_guard<std::mutex> lock(this->indexMutex);
+		if (!this->index) {
+			this->index = this->loadIndex();
+		}
+		return this->index;
+	}
+
+	/**
+	 * reads the device map and the uuid links at once - lookups don't touch the filesystem
+	 * anymore, so resolving all partitions of a list only costs a single load
+	 */
+	private: std::shared_ptr<Index const> loadIndex() const {
+		std::shared_ptr<Index> index = std::make_shared<Index>();
+		char deviceBuf[101];
+
+		index->uuidDirModificationTime = this->getUuidDirModificationTime();
+		std::string uuidDir = this->env->cfg_dir_prefix + "/dev/disk/by-uuid";
+		DIR* dir = opendir(uuidDir.c_str());
+		if (dir) {
+			struct dirent* entry;
+			while ((entry = readdir(dir))) {
+				if (entry->d_name[0] == '.') {
+					continue;
 				}
-	
-				int deviceStartPos = (int)diskFile.size() - diskDevice.size();
-				if (deviceStartPos > 1 && diskFile.substr(deviceStartPos - 1) == "/" + diskDevice) {
-					result.hddNum = rowMatch[1];
-					break;
+				int size = readlinkat(dirfd(dir), entry->d_name, deviceBuf, 100);
+				if (size != -1) {
+					index->partitionDevices[entry->d_name] = std::string(deviceBuf, size);
 				}
 			}
-		} catch (EndOfFileException const& e) {
-			//don't throw if we didn't find the mapped value
+			closedir(dir);
+		}
+
+		Model_SmartFileHandle handle = this->getFileHandle();
+		std::string row;
+		while (handle.readRow(row)) {
+			std::vector<std::string> rowMatch;
+			try {
+				rowMatch = this->regexEngine->match("^\\(hd([0-9]+)\\)[\t ]*(.*)$", row);
+			} catch (RegExNotMatchedException const& e) {
+				continue;
+			}
+			std::string diskFile = rowMatch[2];
+
+			int size = readlink(diskFile.c_str(), deviceBuf, 100); // if this is a link, follow it
+			if (size != -1) {
+				diskFile = std::string(deviceBuf, size);
+			}
+
+			// the first mapping of a disk wins
+			int deviceStartPos = diskFile.find_last_of('/') + 1;
+			if (deviceStartPos > 1 && index->diskNums.find(diskFile.substr(deviceStartPos)) == index->diskNums.end()) {
+				index->diskNums[diskFile.substr(deviceStartPos)] = rowMatch[1];
+			}
 		}
 		handle.close();
-	
-		this->_cache[partitionUuid] = result;
-		return result;
+
+		this->log("device map loaded: " + std::to_string(index->diskNums.size()) + " disks, " + std::to_string(index->partitionDevices.size()) + " partitions", Logger::INFO);
+		return index;
 	}
 
-	void clearCache() {
-		this->_cache.clear();
+	private: time_t getUuidDirModificationTime() const {
+		struct stat uuidDirStat;
+		if (stat((this->env->cfg_dir_prefix + "/dev/disk/by-uuid").c_str(), &uuidDirStat) != 0) {
+			return 0;
+		}
+		return uuidDirStat.st_mtime;
 	}
 
 };
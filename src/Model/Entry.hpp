@@ -112,16 +112,17 @@ class Model_Entry : public Trait_LoggerAware, public Entry
 			endOfEntryName = rowText.find('\'', 10);
 		std::string entryName = rowText.substr(9, endOfEntryName-9);
 	
+		std::shared_ptr<Logger> logger = this->logger; // would be overwritten by the assignment
 		*this = Model_Entry(entryName, "", "", SUBMENU);
-		if (this->logger) {
-			this->setLogger(this->logger);
+		if (logger) {
+			this->setLogger(logger);
 		}
 		Model_Entry_Row row;
 		while ((row = Model_Entry_Row(sourceFile))) {
 			std::string rowText = Helper::ltrim(row.text);
 	
 			if (rowText.substr(0, 10) == "menuentry " || rowText.substr(0, 8) == "submenu "){
-				this->subEntries.push_back(std::make_shared<Model_Entry>(sourceFile, row));
+				this->subEntries.push_back(std::make_shared<Model_Entry>(sourceFile, row, this->logger));
 			} else if (Helper::trim(rowText) == "}") {
 				this->isValid = true;
 				break; //read only one submenu
@@ -142,9 +143,10 @@ class Model_Entry : public Trait_LoggerAware, public Entry
 	
 		std::string extension = rowText.substr(endOfEntryName+1, rowText.length()-(endOfEntryName+1)-1);
 	
+		std::shared_ptr<Logger> logger = this->logger; // would be overwritten by the assignment
 		*this = Model_Entry(entryName, extension);
-		if (this->logger) {
-			this->setLogger(this->logger);
+		if (logger) {
+			this->setLogger(logger);
 		}
 		this->quote = quote;
 	
@@ -25,6 +25,9 @@
 #include <dirent.h>
 #include <map>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <climits>
+#include <mutex>
 
 #include "../lib/ArrayStructure.hpp"
 #include "../lib/Trait/LoggerAware.hpp"
@@ -293,22 +296,69 @@ public:
 	}
 
 	bool check_cmd(std::string const& cmd, std::string const& cmd_prefix = "") const {
-		this->log("checking the " + this->trim_cmd(cmd) + " command… ", Logger::INFO);
-		FILE* proc = popen((cmd_prefix + " which " + this->trim_cmd(cmd) + " 2>&1").c_str(), "r");
-		std::string output;
-		int c;
-		while ((c = fgetc(proc)) != EOF) {
-			if (c != '\n') {
-				output += char(c);
+		// the command may already contain the prefix (like mkdevicemap_cmd after init)
+		std::string cmdName = this->trim_cmd(cmd.compare(0, cmd_prefix.size(), cmd_prefix) == 0 ? cmd.substr(cmd_prefix.size()) : cmd);
+		// cmd_prefix is the chroot call into cfg_dir_prefix
+		std::string dirPrefix = cmd_prefix != "" ? this->cfg_dir_prefix : "";
+
+		this->log("checking the " + cmdName + " command… ", Logger::INFO);
+		std::string path = this->findCommand(cmdName, dirPrefix);
+		if (path != "") {
+			this->log("found at: " + path, Logger::INFO);
+		} else {
+			this->log("not found", Logger::INFO);
+		}
+		return path != "";
+	}
+
+	/**
+	 * resolves the command like `which` (run inside of dirPrefix) would do, but without starting a process.
+	 * Results are cached until one of the searched directories is modified.
+	 * Returns the path relative to dirPrefix or an empty string if the command cannot be found.
+	 */
+	std::string findCommand(std::string const& name, std::string const& dirPrefix = "") const {
+		CommandCache& cache = Model_Env::getCommandCache();
+		std::string cacheKey = dirPrefix + "\n" + name;
+		{
+			std::lock_guard<std::mutex> lock(cache.mutex);
+			std::map<std::string, CommandCacheItem>::iterator itemIter = cache.items.find(cacheKey);
+			if (itemIter != cache.items.end() && this->isCommandCacheItemValid(itemIter->second, dirPrefix)) {
+				return itemIter->second.path;
 			}
 		}
-		bool result = pclose(proc) == 0;
-		if (result == true) {
-			this->log("found at: " + output, Logger::INFO);
+
+		CommandCacheItem item;
+		if (name.find('/') != std::string::npos) {
+			std::string dir = name.substr(0, name.find_last_of('/') + 1);
+			item.searchedDirs[dir] = this->getModificationTime(dirPrefix + dir);
+			if (this->isExecutable(dirPrefix, name)) {
+				item.path = name;
+			}
 		} else {
-			this->log("not found", Logger::INFO);
+			char const* pathVar = getenv("PATH");
+			std::string searchPath = pathVar ? pathVar : "/usr/local/sbin:/usr/local/bin:/usr/sbin:/usr/bin:/sbin:/bin";
+			size_t dirStart = 0;
+			while (item.path == "" && dirStart <= searchPath.size()) {
+				size_t dirEnd = searchPath.find(':', dirStart);
+				if (dirEnd == std::string::npos) {
+					dirEnd = searchPath.size();
+				}
+				std::string dir = searchPath.substr(dirStart, dirEnd - dirStart);
+				dirStart = dirEnd + 1;
+				if (dir == "") {
+					continue;
+				}
+				// directories behind the match don't matter - added files wouldn't be found anyway
+				item.searchedDirs[dir] = this->getModificationTime(dirPrefix + dir);
+				if (this->isExecutable(dirPrefix, dir + "/" + name)) {
+					item.path = dir + "/" + name;
+				}
+			}
 		}
-		return result;
+
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		cache.items[cacheKey] = item;
+		return item.path;
 	}
 
 	bool check_dir(std::string const& dir_str) const {
@@ -348,7 +398,62 @@ public:
 		return mtab.getEntryByMountpoint(cfg_dir_prefix == "" ? "/" : cfg_dir_prefix).device;
 	}
 
-	std::string cfg_dir, cfg_dir_noprefix, mkconfig_cmd, mkfont_cmd, cfg_dir_prefix, update_cmd, install_cmd, output_config_file, output_config_dir, output_config_dir_noprefix, settings_file, devicemap_file, mkdevicemap_cmd, cmd_prefix;
+	private: struct CommandCacheItem {
+		std::string path;
+		std::map<std::string, long long> searchedDirs; // directory -> modification time (ns) at lookup
+	};
+
+	private: struct CommandCache {
+		std::mutex mutex;
+		std::map<std::string, CommandCacheItem> items;
+	};
+
+	// shared by all instances - the filesystem is the same
+	private: static CommandCache& getCommandCache() {
+		static CommandCache cache;
+
+		return cache;
+	}
+
+	private: bool isCommandCacheItemValid(CommandCacheItem const& item, std::string const& dirPrefix) const {
+		for (std::map<std::string, long long>::const_iterator dirIter = item.searchedDirs.begin(); dirIter != item.searchedDirs.end(); dirIter++) {
+			if (this->getModificationTime(dirPrefix + dirIter->first) != dirIter->second) {
+				return false;
+			}
+		}
+		return item.path == "" || this->isExecutable(dirPrefix, item.path);
+	}
+
+	private: long long getModificationTime(std::string const& path) const {
+		struct stat fileStat;
+		if (stat(path.c_str(), &fileStat) != 0) {
+			return -1;
+		}
+		return fileStat.st_mtim.tv_sec * 1000000000LL + fileStat.st_mtim.tv_nsec;
+	}
+
+	// symlinks are resolved inside of dirPrefix - absolute targets would point to the host system otherwise
+	private: bool isExecutable(std::string const& dirPrefix, std::string path) const {
+		char targetBuf[PATH_MAX];
+		for (int linkDepth = 0; linkDepth < 40; linkDepth++) {
+			struct stat fileStat;
+			if (lstat((dirPrefix + path).c_str(), &fileStat) != 0) {
+				return false;
+			}
+			if (!S_ISLNK(fileStat.st_mode)) {
+				return S_ISREG(fileStat.st_mode) && (fileStat.st_mode & 0111);
+			}
+			ssize_t size = readlink((dirPrefix + path).c_str(), targetBuf, sizeof(targetBuf));
+			if (size == -1) {
+				return false;
+			}
+			std::string target(targetBuf, size);
+			path = target[0] == '/' ? target : path.substr(0, path.find_last_of('/') + 1) + target;
+		}
+		return false;
+	}
+
+	public: std::string cfg_dir, cfg_dir_noprefix, mkconfig_cmd, mkfont_cmd, cfg_dir_prefix, update_cmd, install_cmd, output_config_file, output_config_dir, output_config_dir_noprefix, settings_file, devicemap_file, mkdevicemap_cmd, cmd_prefix;
 	bool burgMode;
 	bool useDirectBackgroundProps; // Whether background settings should be set directly or by creating a desktop-base script
 	std::list<Model_Env::Mode> getAvailableModes() {
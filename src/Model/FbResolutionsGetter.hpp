@@ -22,58 +22,233 @@
 #include <list>
 #include <cstdio>
 #include <functional>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <set>
+#include <cctype>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../config.hpp"
 #include "../lib/Trait/LoggerAware.hpp"
 
+/**
+ * Collects the available framebuffer modes. Sources in order of preference:
+ *  1. modes of connected DRM/KMS connectors and of the framebuffer devices (sysfs)
+ *  2. a previous hwinfo result cached for the same hardware
+ *  3. hwinfo --framebuffer (slow and not always installed) - the result gets cached
+ */
 class Model_FbResolutionsGetter : public Trait_LoggerAware {
 	std::list<std::string> data;
 	bool _isLoading;
+	mutable std::mutex dataMutex; // data is loaded by a background thread
 public:
-	Model_FbResolutionsGetter() : _isLoading(false)
+	// prepended to the sysfs paths
+	std::string rootDir;
+	std::string cacheFile;
+
+	Model_FbResolutionsGetter() : _isLoading(false), cacheFile(FB_RESOLUTIONS_CACHE_FILE)
 	{}
 
 	std::function<void ()> onFinish;
 
-	const std::list<std::string>& getData() const {
+	std::list<std::string> getData() const {
+		std::lock_guard<std::mutex> lock(this->dataMutex);
 		return data;
 	}
 
 	void load() {
-		if (!_isLoading){ //make sure that only one thread is running this function at the same time
+		{
+			std::lock_guard<std::mutex> lock(this->dataMutex);
+			if (_isLoading) { //make sure that only one thread is running this function at the same time
+				return;
+			}
 			_isLoading = true;
-			data.clear();
-			FILE* hwinfo_proc = popen("hwinfo --framebuffer", "r");
-			if (hwinfo_proc){
-				int c;
-				std::string row;
-				//parses mode lines like "  Mode 0x0300: 640x400 (+640), 8 bits"
-				while ((c = fgetc(hwinfo_proc)) != EOF){
-					if (c != '\n')
-						row += char(c);
-					else {
-						if (row.substr(0,7) == "  Mode "){
-							int beginOfResulution = row.find(':')+2;
-							int endOfResulution = row.find(' ', beginOfResulution);
-	
-							int beginOfColorDepth = row.find(' ', endOfResulution+1)+1;
-							int endOfColorDepth = row.find(' ', beginOfColorDepth);
-	
-							data.push_back(
-								row.substr(beginOfResulution, endOfResulution-beginOfResulution)
-							  + "x"
-							  + row.substr(beginOfColorDepth, endOfColorDepth-beginOfColorDepth)
-							);
-						}
-						row = "";
-					}
+		}
+
+		std::list<std::string> modes = this->readSysfsModes();
+		if (modes.size()) {
+			this->log("framebuffer modes found in sysfs", Logger::INFO);
+		} else {
+			std::string fingerprint = this->getHardwareFingerprint();
+			if (this->readCache(fingerprint, modes)) {
+				this->log("using cached framebuffer modes", Logger::INFO);
+			} else if (this->readHwinfoModes(modes)) {
+				this->writeCache(fingerprint, modes);
+			} else {
+				std::lock_guard<std::mutex> lock(this->dataMutex);
+				_isLoading = false;
+				return;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->dataMutex);
+			data = modes;
+			_isLoading = false;
+		}
+		if (this->onFinish) {
+			this->onFinish();
+		}
+	}
+
+protected:
+	std::list<std::string> readSysfsModes() const {
+		std::list<std::string> result;
+		std::set<std::string> knownModes;
+
+		// DRM connectors are named like card0-HDMI-A-1, modes are listed like "1920x1080"
+		std::string drmDir = this->rootDir + "/sys/class/drm";
+		for (auto& connector : this->listDir(drmDir)) {
+			if (connector.find('-') == std::string::npos || this->readFile(drmDir + "/" + connector + "/status") != "connected\n") {
+				continue;
+			}
+			std::istringstream modes(this->readFile(drmDir + "/" + connector + "/modes"));
+			std::string mode;
+			while (std::getline(modes, mode)) {
+				if (mode.size() && isdigit(mode[mode.size() - 1]) && knownModes.insert(mode).second) { // skips interlaced modes
+					result.push_back(mode);
 				}
-				if (pclose(hwinfo_proc) == 0 && this->onFinish) {
-					this->onFinish();
+			}
+		}
+
+		// framebuffer modes are listed like "U:1024x768p-0"
+		std::string fbDir = this->rootDir + "/sys/class/graphics";
+		for (auto& fb : this->listDir(fbDir)) {
+			std::string bitsPerPixel = this->readFile(fbDir + "/" + fb + "/bits_per_pixel");
+			bitsPerPixel = bitsPerPixel.substr(0, bitsPerPixel.find('\n'));
+			std::istringstream modes(this->readFile(fbDir + "/" + fb + "/modes"));
+			std::string line;
+			while (std::getline(modes, line)) {
+				size_t begin = line.find(':') + 1;
+				size_t end = line.find_first_not_of("0123456789x", begin);
+				std::string mode = line.substr(begin, end - begin) + (bitsPerPixel != "" ? "x" + bitsPerPixel : "");
+				if (end != begin && knownModes.insert(mode).second) {
+					result.push_back(mode);
 				}
 			}
-			_isLoading = false;
 		}
+		return result;
+	}
+
+	// describes the graphics hardware - the cache is invalidated when it changes
+	std::string getHardwareFingerprint() const {
+		std::string fingerprint;
+		for (auto& file : {"board_vendor", "board_name", "product_name"}) {
+			fingerprint += this->readFile(this->rootDir + "/sys/class/dmi/id/" + file);
+		}
+		std::string drmDir = this->rootDir + "/sys/class/drm";
+		for (auto& card : this->listDir(drmDir)) {
+			fingerprint += card + ":" + this->readFile(drmDir + "/" + card + "/device/vendor") + this->readFile(drmDir + "/" + card + "/device/device");
+		}
+		std::ostringstream hash;
+		hash << std::hex << std::hash<std::string>()(fingerprint);
+		return hash.str();
+	}
+
+	// the cache contains a line "fingerprint <hash>" followed by the modes
+	bool readCache(std::string const& fingerprint, std::list<std::string>& modes) const {
+		std::ifstream cache(this->cacheFile.c_str());
+		std::string line;
+		if (!std::getline(cache, line) || line != "fingerprint " + fingerprint) {
+			return false;
+		}
+		while (std::getline(cache, line)) {
+			modes.push_back(line);
+		}
+		return modes.size() > 0;
+	}
+
+	void writeCache(std::string const& fingerprint, std::list<std::string> const& modes) const {
+		mkdir(this->cacheFile.substr(0, this->cacheFile.find_last_of('/')).c_str(), 0755);
+		// unique temporary file, renamed when complete - concurrent writers don't see partial files
+		std::string tmpFile = this->cacheFile + ".XXXXXX";
+		int fd = mkstemp(&tmpFile[0]);
+		if (fd == -1) {
+			this->log("cannot create framebuffer mode cache " + tmpFile, Logger::INFO);
+			return;
+		}
+		fchmod(fd, 0644);
+		FILE* cache = fdopen(fd, "w");
+		bool success = cache != nullptr;
+		if (success) {
+			success = fprintf(cache, "fingerprint %s\n", fingerprint.c_str()) >= 0;
+			for (auto& mode : modes) {
+				success = success && fprintf(cache, "%s\n", mode.c_str()) >= 0;
+			}
+			success = fclose(cache) == 0 && success;
+		} else {
+			close(fd);
+		}
+		if (!success) {
+			this->log("cannot write framebuffer mode cache " + tmpFile, Logger::INFO);
+			unlink(tmpFile.c_str());
+			return;
+		}
+		if (rename(tmpFile.c_str(), this->cacheFile.c_str()) != 0) {
+			this->log("cannot rename " + tmpFile + " to " + this->cacheFile + ": " + strerror(errno), Logger::INFO);
+			unlink(tmpFile.c_str());
+		}
+	}
+
+	bool readHwinfoModes(std::list<std::string>& modes) const {
+		this->log("running hwinfo to find framebuffer modes", Logger::INFO);
+		FILE* hwinfo_proc = popen("hwinfo --framebuffer 2>/dev/null", "r");
+		if (!hwinfo_proc) {
+			return false;
+		}
+		int c;
+		std::string row;
+		//parses mode lines like "  Mode 0x0300: 640x400 (+640), 8 bits"
+		while ((c = fgetc(hwinfo_proc)) != EOF){
+			if (c != '\n')
+				row += char(c);
+			else {
+				if (row.substr(0,7) == "  Mode "){
+					int beginOfResulution = row.find(':')+2;
+					int endOfResulution = row.find(' ', beginOfResulution);
+
+					int beginOfColorDepth = row.find(' ', endOfResulution+1)+1;
+					int endOfColorDepth = row.find(' ', beginOfColorDepth);
+
+					modes.push_back(
+						row.substr(beginOfResulution, endOfResulution-beginOfResulution)
+					  + "x"
+					  + row.substr(beginOfColorDepth, endOfColorDepth-beginOfColorDepth)
+					);
+				}
+				row = "";
+			}
+		}
+		return pclose(hwinfo_proc) == 0;
 	}
 
+	std::list<std::string> listDir(std::string const& path) const {
+		std::list<std::string> result;
+		DIR* dir = opendir(path.c_str());
+		if (dir) {
+			struct dirent* entry;
+			while ((entry = readdir(dir))) {
+				if (entry->d_name[0] != '.') {
+					result.push_back(entry->d_name);
+				}
+			}
+			closedir(dir);
+		}
+		result.sort();
+		return result;
+	}
+
+	std::string readFile(std::string const& path) const {
+		std::ifstream file(path.c_str());
+		std::ostringstream content;
+		content << file.rdbuf();
+		return content.str();
+	}
 };
 
 class Model_FbResolutionsGetter_Connection
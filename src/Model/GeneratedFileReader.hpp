@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#ifndef GENERATEDFILEREADER_H_INCLUDED
+#define GENERATEDFILEREADER_H_INCLUDED
+#include <cstdio>
+#include <string>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include "../lib/Helper.hpp"
+#include "../lib/Profiler.hpp"
+#include "Entry.hpp"
+#include "Proxylist.hpp"
+#include "Repository.hpp"
+#include "Script.hpp"
+
+/**
+ * parses the output of grub-mkconfig (or a generated grub.cfg) into a repository
+ *
+ * This is the core parser shared by Model_ListCfg and the grubcfg-proxy binary. It
+ * doesn't know anything about locking or progress reporting - Model_ListCfg plugs
+ * these in using the callbacks below.
+ */
+class Model_GeneratedFileReader
+{
+	public: Model_Repository& repository;
+	public: Model_Proxylist& proxies;
+
+	public: std::string cfgDir;
+	public: std::string cfgDirPrefix;
+	public: bool createScriptIfNotFound;
+	public: bool createProxyIfNotFound;
+	public: std::atomic<bool> const* cancelRequested;
+	// passed to the entries created while reading
+	public: std::shared_ptr<Logger> logger;
+
+	public: std::function<void ()> onLock;
+	public: std::function<void ()> onUnlock;
+	// param 1: the script which has been started, param 2: number of scripts started so far
+	public: std::function<void (std::shared_ptr<Model_Script>, int)> onScriptBegin;
+	// called when the END marker of a script has been read
+	public: std::function<void ()> onScriptEnd;
+	// param 1: the current script, param 2: number of scripts started so far, param 3: entries of the current script (max 10)
+	public: std::function<void (std::shared_ptr<Model_Script>, int, int)> onEntryRead;
+
+	public: Model_GeneratedFileReader(Model_Repository& repository, Model_Proxylist& proxies) :
+		repository(repository),
+		proxies(proxies),
+		createScriptIfNotFound(false),
+		createProxyIfNotFound(false),
+		cancelRequested(nullptr)
+	{}
+
+	public: void read(FILE* source)
+	{
+		Model_Entry_Row row;
+		std::shared_ptr<Model_Script> script = nullptr;
+		int i = 0;
+		bool inScript = false;
+		std::string plaintextBuffer = "";
+		int innerCount = 0;
+		std::unique_ptr<Profiler_Scope> scriptTimer; // covers script execution and parsing (mkconfig output is streamed)
+		while (!(this->cancelRequested && *this->cancelRequested) && (row = Model_Entry_Row(source))){
+			std::string rowText = Helper::ltrim(row.text);
+			if (!inScript && rowText.substr(0,10) == ("### BEGIN ") && rowText.substr(rowText.length()-4,4) == " ###"){
+				this->lock();
+				if (script) {
+					this->finishScript(script, plaintextBuffer);
+				}
+				plaintextBuffer = "";
+				std::string scriptName = rowText.substr(10, rowText.length()-14);
+				scriptTimer.reset();
+				scriptTimer.reset(new Profiler_Scope(scriptName, "script"));
+				std::string realScriptName = this->cfgDirPrefix+scriptName;
+				if (realScriptName.substr(0, (this->cfgDir+"/LS_").length()) == this->cfgDir+"/LS_"){
+					realScriptName = this->cfgDirPrefix+Model_GeneratedFileReader::readScriptForwarder(realScriptName);
+				}
+				script = this->repository.getScriptByFilename(realScriptName, this->createScriptIfNotFound);
+				if (this->createScriptIfNotFound && this->createProxyIfNotFound){ //for the compare-configuration
+					this->proxies.push_back(std::make_shared<Model_Proxy>(script));
+				}
+				this->unlock();
+				if (script){
+					++i;
+					if (this->onScriptBegin) {
+						this->onScriptBegin(script, i);
+					}
+				}
+				inScript = true;
+			} else if (inScript && rowText.substr(0,8) == ("### END ") && rowText.substr(rowText.length()-4,4) == " ###") {
+				inScript = false;
+				innerCount = 0;
+				scriptTimer.reset();
+				if (this->onScriptEnd) {
+					this->onScriptEnd();
+				}
+			} else if (script != nullptr && rowText.substr(0, 10) == "menuentry ") {
+				this->lock();
+				if (innerCount < 10) {
+					innerCount++;
+				}
+				auto newEntry = std::make_shared<Model_Entry>(source, row, this->logger);
+				if (!script->isModified()) {
+					script->entries().push_back(newEntry);
+				}
+				this->proxies.sync_all(false, false, script);
+				this->unlock();
+				if (this->onEntryRead) {
+					this->onEntryRead(script, i, innerCount);
+				}
+			} else if (script != nullptr && rowText.substr(0, 8) == "submenu ") {
+				this->lock();
+				auto newEntry = std::make_shared<Model_Entry>(source, row, this->logger);
+				script->entries().push_back(newEntry);
+				this->proxies.sync_all(false, false, script);
+				this->unlock();
+				if (this->onEntryRead) {
+					this->onEntryRead(script, i, innerCount);
+				}
+			} else if (inScript) { //Plaintext
+				plaintextBuffer += row.text + "\n";
+			}
+		}
+		scriptTimer.reset();
+		this->lock();
+		if (script) {
+			this->finishScript(script, plaintextBuffer);
+		}
+
+		// sync all (including foreign entries)
+		Profiler_Scope syncTimer("sync", "ListCfg");
+		this->proxies.sync_all(true, true, nullptr, this->repository.getScriptPathMap());
+		syncTimer.stop();
+
+		this->unlock();
+	}
+
+	public: static std::string readScriptForwarder(std::string const& scriptForwarderFilePath)
+	{
+		std::string result;
+		FILE* scriptForwarderFile = fopen(scriptForwarderFilePath.c_str(), "r");
+		if (scriptForwarderFile){
+			int c;
+			while ((c = fgetc(scriptForwarderFile)) != EOF && c != '\n'){} //skip first line
+			if (c != EOF)
+				while ((c = fgetc(scriptForwarderFile)) != EOF && c != '\n'){result += char(c);} //read second line (='path' or script='path')
+			fclose(scriptForwarderFile);
+		}
+		size_t pathEnd = result.rfind('\'');
+		size_t pathBegin = pathEnd != std::string::npos && pathEnd != 0 ? result.rfind('\'', pathEnd - 1) : std::string::npos;
+		if (pathBegin != std::string::npos) {
+			return result.substr(pathBegin + 1, pathEnd - pathBegin - 1);
+		} else {
+			return "";
+		}
+	}
+
+	private: void finishScript(std::shared_ptr<Model_Script> script, std::string const& plaintextBuffer)
+	{
+		if (plaintextBuffer != "" && !script->isModified()) {
+			auto newEntry = std::make_shared<Model_Entry>("#text", "", plaintextBuffer, Model_Entry::PLAINTEXT);
+			if (this->logger) {
+				newEntry->setLogger(this->logger);
+			}
+			script->entries().push_front(newEntry);
+		}
+		this->proxies.sync_all(true, true, script);
+	}
+
+	private: void lock()
+	{
+		if (this->onLock) {
+			this->onLock();
+		}
+	}
+
+	private: void unlock()
+	{
+		if (this->onUnlock) {
+			this->onUnlock();
+		}
+	}
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include <sstream>
 #include <iomanip>
 #include <map>
+#include <array>
 #include <libintl.h>
 #include <unistd.h>
 #include <fstream>
@@ -38,14 +39,23 @@
 #include "../lib/Exception.hpp"
 #include "../lib/ArrayStructure.hpp"
 #include "../lib/Helper.hpp"
+#include "../lib/Profiler.hpp"
+#include "../lib/Process.hpp"
+#include "../lib/FileSystem.hpp"
 #include <stack>
 #include <algorithm>
 #include <functional>
+#include <atomic>
+#include <mutex>
 #include "Env.hpp"
+#include "GeneratedFileReader.hpp"
 #include "MountTable.hpp"
 #include "Proxylist.hpp"
 #include "ProxyScriptData.hpp"
+#include "ScriptDirectory.hpp"
+#include "ProgressChannel.hpp"
 #include "Repository.hpp"
+#include "ScriptProfile.hpp"
 #include "ScriptSourceMap.hpp"
 #include "SettingsManagerData.hpp"
 
@@ -54,23 +64,28 @@ class Model_ListCfg :
 	public Mutex_Connection,
 	public Model_Env_Connection
 {
-	private: double progress;
-	private: std::string progress_name;
-	private: int progress_pos, progress_max;
-	private: std::string errorLogFile;
+	private: Model_ProgressChannel progressChannel;
+	private: std::string mkconfigErrorOutput;
 
 	private: Model_ScriptSourceMap scriptSourceMap;
+	private: Model_ScriptDirectory cfgDirScan; // taken over by load() if the directory hasn't changed since cfgDirIsClean()
+	private: std::mutex cfgDirScanMutex; // cfgDirIsClean() and load() run in different threads
+
+	// when set, load() runs every script through a profiling forwarder
+	public: bool profileScripts;
+	public: Model_ScriptProfile scriptProfile;
 
 	public: Model_ListCfg() : error_proxy_not_found(false),
-	 progress(0),
-	 cancelThreadsRequested(false), verbose(true),
-	 errorLogFile(ERROR_LOG_FILE), ignoreLock(false), progress_pos(0), progress_max(0)
+	 progressChannel(PROGRESS_FRAME_RATE),
+	 cancelThreadsRequested(false), verbose(true), profileScripts(false),
+	 mkconfigTimeout(MKCONFIG_TIMEOUT), updateTimeout(MKCONFIG_TIMEOUT), ignoreLock(false)
 	{}
 
 	public: void initLogger() override {
 		this->proxies.setLogger(this->logger);
 		this->repository.setLogger(this->logger);
 		this->scriptSourceMap.setLogger(this->logger);
+		this->scriptProfile.setLogger(this->logger);
 	}
 
 	public: void initEnv() override {
@@ -82,6 +97,8 @@ class Model_ListCfg :
 	public: Model_Repository repository;
 	
 	public: std::function<void ()> onLoadStateChange;
+	// called with a delay (in milliseconds) after a rate-limited load state change has been suppressed
+	public: std::function<void (int delayInMilliSec)> onLoadStateChangeDeferred;
 	public: std::function<void ()> onSaveStateChange;
 
 	public: bool verbose;
@@ -110,22 +127,62 @@ class Model_ListCfg :
 		this->mutex->unlock();
 	}
 
+	/**
+	 * read-only access - doesn't block other readers like the gui while loading,
+	 * but waits until the current modification (e.g. adding an entry) is finished
+	 */
+	public: void lockShared() {
+		if (this->ignoreLock)
+			return;
+		if (this->mutex == NULL)
+			throw ConfigException("missing mutex", __FILE__, __LINE__);
+		this->mutex->lockShared();
+	}
+
+	public: bool lockShared_if_free() {
+		if (this->ignoreLock)
+			return true;
+		if (this->mutex == NULL)
+			throw ConfigException("missing mutex", __FILE__, __LINE__);
+		return this->mutex->trylockShared();
+	}
+
+	public: void unlockShared() {
+		if (this->ignoreLock)
+			return;
+		if (this->mutex == NULL)
+			throw ConfigException("missing mutex", __FILE__, __LINE__);
+		this->mutex->unlockShared();
+	}
+
 	public: bool ignoreLock;
 	
-	public: bool cancelThreadsRequested;
+	public: std::atomic<bool> cancelThreadsRequested;
 
-	public: bool createScriptForwarder(std::string const& scriptName) const
+	// seconds until a hanging mkconfig / update command gets killed, 0 = unlimited
+	public: int mkconfigTimeout;
+	public: int updateTimeout;
+
+	public: std::string getScriptForwarderName(std::string const& scriptName) const
 	{
-		//replace: $cfg_dir/proxifiedScripts/ -> $cfg_dir/LS_
-		std::string scriptNameNoPath = scriptName.substr((this->env->cfg_dir+"/proxifiedScripts/").length());
-		std::string outputFilePath = this->env->cfg_dir+"/LS_"+scriptNameNoPath;
+		//replace: $cfg_dir/proxifiedScripts/ -> $cfg_dir/LS_ (when profiling also: $cfg_dir/ -> $cfg_dir/LS_)
+		return "LS_"+scriptName.substr(scriptName.rfind('/') + 1);
+	}
+
+	public: bool createScriptForwarder(std::string const& scriptName, std::string const& interpreter = "") const
+	{
+		std::string outputFilePath = this->env->cfg_dir+"/"+this->getScriptForwarderName(scriptName);
 		FILE* existingScript = fopen(outputFilePath.c_str(), "r");
 		if (existingScript == NULL){
 			Helper::assert_filepath_empty(outputFilePath, __FILE__, __LINE__);
 			FILE* fwdScript = fopen(outputFilePath.c_str(), "w");
 			if (fwdScript){
-				fputs("#!/bin/sh\n", fwdScript);
-				fputs(("'"+scriptName.substr(env->cfg_dir_prefix.length())+"'").c_str(), fwdScript);
+				if (this->scriptProfile.isRunning()) {
+					fputs(this->scriptProfile.buildForwarder(scriptName.substr(env->cfg_dir_prefix.length()), interpreter, this->getScriptForwarderName(scriptName)).c_str(), fwdScript);
+				} else {
+					fputs("#!/bin/sh\n", fwdScript);
+					fputs(("'"+scriptName.substr(env->cfg_dir_prefix.length())+"'").c_str(), fwdScript);
+				}
 				fclose(fwdScript);
 				chmod(outputFilePath.c_str(), 0755);
 				return true;
@@ -141,78 +198,78 @@ class Model_ListCfg :
 
 	public: bool removeScriptForwarder(std::string const& scriptName) const
 	{
-		std::string scriptNameNoPath = scriptName.substr((this->env->cfg_dir+"/proxifiedScripts/").length());
-		std::string filePath = this->env->cfg_dir+"/LS_"+scriptNameNoPath;
+		std::string filePath = this->env->cfg_dir+"/"+this->getScriptForwarderName(scriptName);
 		return unlink(filePath.c_str()) == 0;
 	}
 
-	public: std::string readScriptForwarder(std::string const& scriptForwarderFilePath) const {
-		std::string result;
-		FILE* scriptForwarderFile = fopen(scriptForwarderFilePath.c_str(), "r");
-		if (scriptForwarderFile){
-			int c;
-			while ((c = fgetc(scriptForwarderFile)) != EOF && c != '\n'){} //skip first line
-			if (c != EOF)
-				while ((c = fgetc(scriptForwarderFile)) != EOF && c != '\n'){result += char(c);} //read second line (=path)
-			fclose(scriptForwarderFile);
+	// removes the forwarders created by load() and resets the permissions of the proxies
+	private: void restoreScriptFiles(std::list<std::string> const& forwardedScripts, std::list<std::pair<std::string, mode_t>> const& changedPermissions)
+	{
+		for (auto& scriptFileName : forwardedScripts) {
+			if (!removeScriptForwarder(scriptFileName)) {
+				this->log("removing of script forwarder not successful!", Logger::ERROR);
+			}
 		}
-		if (result.length() >= 3) {
-			return result.substr(1, result.length()-2);
-		} else {
-			return "";
+		for (auto& permissions : changedPermissions) {
+			chmod(permissions.first.c_str(), permissions.second);
 		}
 	}
 
+	public: std::string readScriptForwarder(std::string const& scriptForwarderFilePath) const {
+		return Model_GeneratedFileReader::readScriptForwarder(scriptForwarderFilePath);
+	}
+
 	public: void load(bool preserveConfig = false)
 	{
 		if (!preserveConfig){
 			send_new_load_progress(0);
 	
-			DIR* hGrubCfgDir = opendir(this->env->cfg_dir.c_str());
-	
-			if (!hGrubCfgDir){
-				throw DirectoryNotFoundException("grub cfg dir not found", __FILE__, __LINE__);
-			}
-	
 			//load scripts
 			this->log("loading scripts…", Logger::EVENT);
+			Profiler_Scope repositoryScanTimer("repository scan", "ListCfg");
+			Model_ScriptDirectory cfgDir;
+			{
+				std::lock_guard<std::mutex> lock(this->cfgDirScanMutex);
+				if (this->cfgDirScan.isUpToDate()) {
+					cfgDir = std::move(this->cfgDirScan);
+				}
+				this->cfgDirScan = Model_ScriptDirectory();
+			}
+			if (!cfgDir.isLoaded() && !cfgDir.load(this->env->cfg_dir)) {
+				throw DirectoryNotFoundException("grub cfg dir not found", __FILE__, __LINE__);
+			}
+			Model_ScriptDirectory proxifiedScriptDir;
+			proxifiedScriptDir.load(this->env->cfg_dir+"/proxifiedScripts");
+
 			this->lock();
-			repository.load(this->env->cfg_dir, false);
-			repository.load(this->env->cfg_dir+"/proxifiedScripts", true);
+			repository.load(cfgDir, false);
+			repository.load(proxifiedScriptDir, true);
 			this->unlock();
+			repositoryScanTimer.stop();
 			send_new_load_progress(0.05);
 		
 		
 			//load proxies
 			this->log("loading proxies…", Logger::EVENT);
+			Profiler_Scope proxyScanTimer("proxy scan", "ListCfg");
 			this->lock();
-			struct dirent *entry;
-			struct stat fileProperties;
-			while ((entry = readdir(hGrubCfgDir))){
-				stat((this->env->cfg_dir+"/"+entry->d_name).c_str(), &fileProperties);
-				if ((fileProperties.st_mode & S_IFMT) != S_IFDIR){ //ignore directories
-					if (entry->d_name[2] == '_'){ //check whether it's an script (they should be named XX_scriptname)…
-						this->proxies.push_back(std::make_shared<Model_Proxy>());
-						this->proxies.back()->fileName = this->env->cfg_dir+"/"+entry->d_name;
-						this->proxies.back()->index = (entry->d_name[0]-'0')*10 + (entry->d_name[1]-'0');
-						this->proxies.back()->permissions = fileProperties.st_mode & ~S_IFMT;
-					
-						FILE* proxyFile = fopen((this->env->cfg_dir+"/"+entry->d_name).c_str(), "r");
-						Model_ProxyScriptData data(proxyFile);
-						fclose(proxyFile);
-						if (data){
-							this->proxies.back()->dataSource = repository.getScriptByFilename(this->env->cfg_dir_prefix+data.scriptCmd);
-							this->proxies.back()->importRuleString(data.ruleString.c_str(), this->env->cfg_dir_prefix);
-						}
-						else {
-							this->proxies.back()->dataSource = repository.getScriptByFilename(this->env->cfg_dir+"/"+entry->d_name);
-							this->proxies.back()->importRuleString("+*", this->env->cfg_dir_prefix); //it's no proxy, so accept all
-						}
-					
+			for (auto& file : cfgDir.files) {
+				if (file.name.length() >= 3 && file.name[2] == '_' && file.type != Model_ScriptDirectory_File::FORWARDER){ //check whether it's an script (they should be named XX_scriptname)…
+					this->proxies.push_back(std::make_shared<Model_Proxy>());
+					this->proxies.back()->fileName = this->env->cfg_dir+"/"+file.name;
+					this->proxies.back()->index = (file.name[0]-'0')*10 + (file.name[1]-'0');
+					this->proxies.back()->permissions = file.permissions;
+				
+					if (file.proxyData){
+						this->proxies.back()->dataSource = repository.getScriptByFilename(this->env->cfg_dir_prefix+file.proxyData.scriptCmd);
+						this->proxies.back()->importRuleString(file.proxyData.ruleString.c_str(), this->env->cfg_dir_prefix);
+					}
+					else {
+						this->proxies.back()->dataSource = repository.getScriptByFilename(this->env->cfg_dir+"/"+file.name);
+						this->proxies.back()->importRuleString("+*", this->env->cfg_dir_prefix); //it's no proxy, so accept all
 					}
 				}
 			}
-			closedir(hGrubCfgDir);
 			this->proxies.sort();
 			this->unlock();
 	
@@ -221,20 +278,17 @@ class Model_ListCfg :
 			this->log("cleaning up proxy configuration…", Logger::EVENT);
 			this->lock();
 	
-			bool proxyRemoved = false;
-			do {
-				for (auto proxy : this->proxies) {
-					if (!proxy->isExecutable() || !proxy->hasVisibleRules()) {
-						this->log(proxy->fileName + " has no visible entries and will be removed / disabled", Logger::INFO);
-						this->proxies.deleteProxy(proxy);
-						proxyRemoved = true;
-						break;
-					}
+			for (auto proxyIter = this->proxies.begin(); proxyIter != this->proxies.end();) {
+				if (!(*proxyIter)->isExecutable() || !(*proxyIter)->hasVisibleRules()) {
+					this->log((*proxyIter)->fileName + " has no visible entries and will be removed / disabled", Logger::INFO);
+					proxyIter = this->proxies.deleteProxy(proxyIter);
+				} else {
+					proxyIter++;
 				}
-				proxyRemoved = false;
-			} while (proxyRemoved);
+			}
 	
 			this->unlock();
+			proxyScanTimer.stop();
 		} else {
 			this->lock();
 			proxies.unsync_all();
@@ -244,50 +298,91 @@ class Model_ListCfg :
 	
 		//create proxifiedScript links & chmod other files
 		this->log("creating proxifiedScript links & chmodding other files…", Logger::EVENT);
+		Profiler_Scope forwarderCreationTimer("forwarder creation", "ListCfg");
+		if (this->profileScripts) {
+			try {
+				this->scriptProfile.start(this->env->cfg_dir_prefix);
+			} catch (FileSaveException const& e) {
+				this->log(e.getMessage() + " - loading without script profile", Logger::ERROR);
+			}
+		}
 	
-		this->lock();
-		for (auto script : this->repository) {
-			if (script->isInScriptDir(env->cfg_dir)){
-				//createScriptForwarder & disable proxies
-				createScriptForwarder(script->fileName);
+		// everything changed from here on is reverted by restoreScriptFiles - also when loading fails
+		std::list<std::string> forwardedScripts;
+		std::list<std::pair<std::string, mode_t>> changedPermissions;
+		this->lockShared(); // file system changes only
+		try {
+			for (auto script : this->repository) {
 				auto relatedProxies = proxies.getProxiesByScript(script);
 				for (auto proxy : relatedProxies) {
-					int res = chmod(proxy->fileName.c_str(), 0644);
+					changedPermissions.push_back(std::make_pair(proxy->fileName, proxy->permissions));
+				}
+				if (script->isInScriptDir(env->cfg_dir)){
+					//createScriptForwarder & disable proxies
+					forwardedScripts.push_back(script->fileName);
+					createScriptForwarder(script->fileName);
+					for (auto proxy : relatedProxies) {
+						int res = chmod(proxy->fileName.c_str(), 0644);
+					}
+				} else if (this->scriptProfile.isRunning()) {
+					//run unproxified scripts through a profiling forwarder too (permissions are restored later)
+					forwardedScripts.push_back(script->fileName);
+					createScriptForwarder(script->fileName, Model_ScriptProfile::readInterpreter(script->fileName));
+					chmod(script->fileName.c_str(), 0644);
+				} else {
+					//enable scripts (unproxified), in this case, Proxy::fileName == Script::fileName
+					chmod(script->fileName.c_str(), 0755);
 				}
-			} else {
-				//enable scripts (unproxified), in this case, Proxy::fileName == Script::fileName
-				chmod(script->fileName.c_str(), 0755);
 			}
+		} catch (...) {
+			this->unlockShared();
+			this->restoreScriptFiles(forwardedScripts, changedPermissions);
+			throw;
 		}
-		this->unlock();
+		this->unlockShared();
+		forwarderCreationTimer.stop();
 		send_new_load_progress(0.1);
 	
-	
-		if (!preserveConfig){
-			//load script map
-			this->scriptSourceMap.load();
-			if (!this->scriptSourceMap.fileExists() && this->getProxifiedScripts().size() > 0) {
-				this->generateScriptSourceMap();
+		try {
+			if (!preserveConfig){
+				//load script map
+				this->scriptSourceMap.load();
+				if (!this->scriptSourceMap.fileExists() && this->getProxifiedScripts().size() > 0) {
+					this->generateScriptSourceMap();
+				}
+				this->populateScriptSourceMap();
 			}
-			this->populateScriptSourceMap();
-		}
-	
-		//run mkconfig
-		this->log("running " + this->env->mkconfig_cmd, Logger::EVENT);
-		FILE* mkconfigProc = popen((this->env->mkconfig_cmd + " 2> " + this->errorLogFile).c_str(), "r");
-		readGeneratedFile(mkconfigProc);
 		
-		int success = pclose(mkconfigProc);
-		if (success != 0 && !cancelThreadsRequested){
-			throw CmdExecException("failed running " + this->env->mkconfig_cmd, __FILE__, __LINE__);
-		} else {
-			remove(errorLogFile.c_str()); //remove file, if everything was ok
+			//run mkconfig
+			this->log("running " + this->env->mkconfig_cmd, Logger::EVENT);
+			Profiler_Scope mkconfigTimer("mkconfig run", "ListCfg");
+			Process mkconfigProc(this->env->mkconfig_cmd);
+			mkconfigProc.timeout = this->mkconfigTimeout;
+			mkconfigProc.cancelRequested = &this->cancelThreadsRequested;
+			readGeneratedFile(mkconfigProc.start());
+			
+			int success = mkconfigProc.wait();
+			this->mkconfigErrorOutput = mkconfigProc.getErrorOutput();
+			mkconfigTimer.stop();
+			if (this->scriptProfile.isRunning()) {
+				this->scriptProfile.finish();
+			}
+			if (mkconfigProc.isTimedOut()) {
+				throw CmdExecException("timeout while running " + this->env->mkconfig_cmd, __FILE__, __LINE__);
+			}
+			if (success != 0 && !cancelThreadsRequested){
+				throw CmdExecException("failed running " + this->env->mkconfig_cmd, __FILE__, __LINE__);
+			}
+		} catch (...) {
+			if (this->scriptProfile.isRunning()) {
+				this->scriptProfile.finish();
+			}
+			this->restoreScriptFiles(forwardedScripts, changedPermissions);
+			throw;
 		}
 		this->log("mkconfig successfull completed", Logger::INFO);
 	
 		this->send_new_load_progress(0.9);
-	
-		mkconfigProc = NULL;
 		
 		this->env->useDirectBackgroundProps = this->repository.getScriptByName("debian_theme") == NULL;
 		if (this->env->useDirectBackgroundProps) {
@@ -299,38 +394,22 @@ class Model_ListCfg :
 		
 		//restore old configuration
 		this->log("restoring grub configuration", Logger::EVENT);
-		this->lock();
-		for (auto script : this->repository){
-			if (script->isInScriptDir(env->cfg_dir)){
-				//removeScriptForwarder & reset proxy permissions
-				bool result = removeScriptForwarder(script->fileName);
-				if (!result) {
-					this->log("removing of script forwarder not successful!", Logger::ERROR);
-				}
-			}
-			auto relatedProxies = proxies.getProxiesByScript(script);
-			for (auto proxy : relatedProxies){
-				chmod(proxy->fileName.c_str(), proxy->permissions);
-			}
-		}
-		this->unlock();
+		Profiler_Scope restoreTimer("restore", "ListCfg");
+		this->restoreScriptFiles(forwardedScripts, changedPermissions);
 		
 		//remove invalid proxies from list (no file system action here)
 		this->log("removing invalid proxies from list", Logger::EVENT);
+		this->lock();
 		std::string invalidProxies = "";
-		bool foundInvalidScript = false;
-		do {
-			foundInvalidScript = false;
-			for (auto proxy : this->proxies) {
-				if (proxy->dataSource == nullptr) {
-					this->proxies.trash.push_back(proxy); // mark for deletion
-					this->proxies.erase(this->proxies.getIter(proxy));
-					foundInvalidScript = true;
-					invalidProxies += proxy->fileName + ",";
-					break;
-				}
+		for (auto proxyIter = this->proxies.begin(); proxyIter != this->proxies.end();) {
+			if ((*proxyIter)->dataSource == nullptr) {
+				this->proxies.trash.push_back(*proxyIter); // mark for deletion
+				invalidProxies += (*proxyIter)->fileName + ",";
+				proxyIter = this->proxies.erase(proxyIter);
+			} else {
+				proxyIter++;
 			}
-		} while (foundInvalidScript);
+		}
 	
 		if (invalidProxies != "") {
 			this->log("found invalid proxies: " + Helper::rtrim(invalidProxies, ","), Logger::INFO);
@@ -341,6 +420,8 @@ class Model_ListCfg :
 			this->log("found conflicts - renumerating", Logger::INFO);
 			this->renumerate();
 		}
+		this->unlock();
+		restoreTimer.stop();
 	
 		this->log("loading completed", Logger::EVENT);
 		send_new_load_progress(1);
@@ -389,6 +470,7 @@ class Model_ListCfg :
 		}
 	
 		// move scripts and create proxies
+		Profiler_Scope proxyGenerationTimer("proxy generation", "ListCfg");
 		int proxyCount = 0;
 		for (auto script : repository) {
 			auto relatedProxies = proxies.getProxiesByScript(script);
@@ -460,22 +542,15 @@ class Model_ListCfg :
 			// create the bin subdirectory - may already exist
 			int bin_mk_success = mkdir((this->env->cfg_dir+"/bin").c_str(), 0755);
 	
-			FILE* proxyBinSource = fopen((std::string(LIBDIR)+"/grubcfg-proxy").c_str(), "r");
-			
-			if (proxyBinSource){
-				FILE* proxyBinTarget = fopen((this->env->cfg_dir+"/bin/grubcfg_proxy").c_str(), "w");
-				if (proxyBinTarget){
-					int c;
-					while ((c = fgetc(proxyBinSource)) != EOF){
-						fputc(c, proxyBinTarget);
-					}
-					fclose(proxyBinTarget);
-					chmod((this->env->cfg_dir+"/bin/grubcfg_proxy").c_str(), 0755);
+			try {
+				if (FileSystem().install(std::string(LIBDIR)+"/grubcfg-proxy", this->env->cfg_dir+"/bin/grubcfg_proxy", 0755)) {
+					this->log("proxy binary installed", Logger::INFO);
 				} else {
-					this->log("could not open proxy output file!", Logger::ERROR);
+					this->log("proxy binary is up to date", Logger::INFO);
 				}
-				fclose(proxyBinSource);
-			} else {
+			} catch (FileSaveException const& e) {
+				this->log("could not write proxy output file!", Logger::ERROR);
+			} catch (FileReadException const& e) {
 				this->log("proxy could not be copied, generating dummy!", Logger::ERROR);
 				FILE* proxyBinTarget = fopen((this->env->cfg_dir+"/bin/grubcfg_proxy").c_str(), "w");
 				if (proxyBinTarget){
@@ -494,6 +569,8 @@ class Model_ListCfg :
 			rmdir((this->env->cfg_dir+"/bin").c_str());
 		}
 	
+		proxyGenerationTimer.stop();
+
 		//update modified "custom" scripts
 		for (auto script : this->repository) {
 			if (script->isCustomScript && script->isModified()) {
@@ -516,22 +593,24 @@ class Model_ListCfg :
 		std::string saveProcOutput;
 	
 		//run update-grub
-		FILE* saveProc = popen((env->update_cmd + " 2>&1").c_str(), "r");
-		if (saveProc) {
-			int c;
-			std::string row = "";
-			while ((c = fgetc(saveProc)) != EOF) {
-				saveProcOutput += char(c);
-				if (c == '\n') {
-					send_new_save_progress(0.5); //a gui should use pulse() instead of set_fraction
-					this->log(row, Logger::INFO);
-					row = "";
-				} else {
-					row += char(c);
-				}
+		Profiler_Scope updateGrubTimer("update-grub", "ListCfg");
+		Process saveProc(env->update_cmd + " 2>&1");
+		saveProc.timeout = this->updateTimeout; // not cancellable - quitting waits until the configuration is saved
+		FILE* saveProcOutputStream = saveProc.start();
+		int c;
+		std::string row = "";
+		while ((c = fgetc(saveProcOutputStream)) != EOF) {
+			saveProcOutput += char(c);
+			if (c == '\n') {
+				send_new_save_progress(0.5); //a gui should use pulse() instead of set_fraction
+				this->log(row, Logger::INFO);
+				row = "";
+			} else {
+				row += char(c);
 			}
-			saveProcSuccess = pclose(saveProc);
 		}
+		saveProcSuccess = saveProc.wait();
+		updateGrubTimer.stop();
 	
 		// correct pathes of foreign rules (to make sure re-syncing works)
 		auto foreignRules = this->proxies.getForeignRules();
@@ -545,6 +624,9 @@ class Model_ListCfg :
 	
 		send_new_save_progress(1);
 	
+		if (saveProc.isTimedOut()) {
+			throw CmdExecException("timeout while running '" + env->update_cmd + "' output:\n" + saveProcOutput, __FILE__, __LINE__);
+		}
 		if ((saveProcSuccess != 0 || saveProcOutput.find("Syntax errors are detected in generated GRUB config file") != -1)){
 			throw CmdExecException("failed running '" + env->update_cmd + "' output:\n" + saveProcOutput, __FILE__, __LINE__);
 		}
@@ -552,85 +634,32 @@ class Model_ListCfg :
 
 	public: void readGeneratedFile(FILE* source, bool createScriptIfNotFound = false, bool createProxyIfNotFound = false)
 	{
-		Model_Entry_Row row;
-		std::shared_ptr<Model_Script> script = nullptr;
-		int i = 0;
-		bool inScript = false;
-		std::string plaintextBuffer = "";
-		int innerCount = 0;
 		double progressbarScriptSpace = 0.7 / this->repository.size();
-		while (!cancelThreadsRequested && (row = Model_Entry_Row(source))){
-			std::string rowText = Helper::ltrim(row.text);
-			if (!inScript && rowText.substr(0,10) == ("### BEGIN ") && rowText.substr(rowText.length()-4,4) == " ###"){
-				this->lock();
-				if (script) {
-					if (plaintextBuffer != "" && !script->isModified()) {
-						auto newEntry = std::make_shared<Model_Entry>("#text", "", plaintextBuffer, Model_Entry::PLAINTEXT);
-						if (this->hasLogger()) {
-							newEntry->setLogger(this->getLogger());
-						}
-						script->entries().push_front(newEntry);
-					}
-					this->proxies.sync_all(true, true, script);
-				}
-				plaintextBuffer = "";
-				std::string scriptName = rowText.substr(10, rowText.length()-14);
-				std::string prefix = this->env->cfg_dir_prefix;
-				std::string realScriptName = prefix+scriptName;
-				if (realScriptName.substr(0, (this->env->cfg_dir+"/LS_").length()) == this->env->cfg_dir+"/LS_"){
-					realScriptName = prefix+readScriptForwarder(realScriptName);
-				}
-				script = repository.getScriptByFilename(realScriptName, createScriptIfNotFound);
-				if (createScriptIfNotFound && createProxyIfNotFound){ //for the compare-configuration
-					this->proxies.push_back(std::make_shared<Model_Proxy>(script));
-				}
-				this->unlock();
-				if (script){
-					this->send_new_load_progress(0.1 + (progressbarScriptSpace * ++i + (progressbarScriptSpace/10*innerCount)), script->name, i, this->repository.size());
-				}
-				inScript = true;
-			} else if (inScript && rowText.substr(0,8) == ("### END ") && rowText.substr(rowText.length()-4,4) == " ###") {
-				inScript = false;
-				innerCount = 0;
-			} else if (script != nullptr && rowText.substr(0, 10) == "menuentry ") {
-				this->lock();
-				if (innerCount < 10) {
-					innerCount++;
-				}
-				auto newEntry = std::make_shared<Model_Entry>(source, row, this->getLogger());
-				if (!script->isModified()) {
-					script->entries().push_back(newEntry);
-				}
-				this->proxies.sync_all(false, false, script);
-				this->unlock();
-				this->send_new_load_progress(0.1 + (progressbarScriptSpace * i + (progressbarScriptSpace/10*innerCount)), script->name, i, this->repository.size());
-			} else if (script != NULL && rowText.substr(0, 8) == "submenu ") {
-				this->lock();
-				auto newEntry = std::make_shared<Model_Entry>(source, row, this->getLogger());
-				script->entries().push_back(newEntry);
-				this->proxies.sync_all(false, false, script);
-				this->unlock();
-				this->send_new_load_progress(0.1 + (progressbarScriptSpace * i + (progressbarScriptSpace/10*innerCount)), script->name, i, this->repository.size());
-			} else if (inScript) { //Plaintext
-				plaintextBuffer += row.text + "\n";
+
+		Model_GeneratedFileReader reader(this->repository, this->proxies);
+		reader.cfgDir = this->env->cfg_dir;
+		reader.cfgDirPrefix = this->env->cfg_dir_prefix;
+		reader.createScriptIfNotFound = createScriptIfNotFound;
+		reader.createProxyIfNotFound = createProxyIfNotFound;
+		reader.cancelRequested = &this->cancelThreadsRequested;
+		reader.logger = this->getLogger();
+		reader.onLock = [this] () {this->lock();};
+		reader.onUnlock = [this] () {this->unlock();};
+		reader.onScriptBegin = [this, progressbarScriptSpace] (std::shared_ptr<Model_Script> script, int i) {
+			if (this->scriptProfile.isRunning()) {
+				this->scriptProfile.begin(script->fileName, this->getScriptForwarderName(script->fileName));
 			}
-		}
-		this->lock();
-		if (script) {
-			if (plaintextBuffer != "" && !script->isModified()) {
-				auto newEntry = std::make_shared<Model_Entry>("#text", "", plaintextBuffer, Model_Entry::PLAINTEXT);
-				if (this->hasLogger()) {
-					newEntry->setLogger(this->getLogger());
-				}
-				script->entries().push_front(newEntry);
+			this->send_new_load_progress(0.1 + progressbarScriptSpace * i, script->name, i, this->repository.size());
+		};
+		reader.onScriptEnd = [this] () {
+			if (this->scriptProfile.isRunning()) {
+				this->scriptProfile.end();
 			}
-			this->proxies.sync_all(true, true, script);
-		}
-	
-		// sync all (including foreign entries)
-		this->proxies.sync_all(true, true, nullptr, this->repository.getScriptPathMap());
-	
-		this->unlock();
+		};
+		reader.onEntryRead = [this, progressbarScriptSpace] (std::shared_ptr<Model_Script> script, int i, int innerCount) {
+			this->send_new_load_progress(0.1 + (progressbarScriptSpace * i + (progressbarScriptSpace/10*innerCount)), script->name, i, this->repository.size());
+		};
+		reader.read(source);
 	}
 
 	public: std::map<std::shared_ptr<Model_Entry>, std::shared_ptr<Model_Script>> getEntrySources(
@@ -675,11 +704,11 @@ class Model_ListCfg :
 	public: void send_new_load_progress(double newProgress, std::string scriptName = "", int current = 0, int max = 0)
 	{
 		if (this->onLoadStateChange){
-			this->progress = newProgress;
-			this->progress_name = scriptName;
-			this->progress_pos = current;
-			this->progress_max = max;
-			this->onLoadStateChange();
+			if (this->progressChannel.publish(newProgress, scriptName, current, max)) {
+				this->onLoadStateChange();
+			} else {
+				this->deferLoadStateChange();
+			}
 		} else if (this->verbose) {
 			this->log("cannot show updated load progress - no event handler assigned!", Logger::ERROR);
 		}
@@ -688,8 +717,9 @@ class Model_ListCfg :
 	public: void send_new_save_progress(double newProgress)
 	{
 		if (this->onSaveStateChange){
-			this->progress = newProgress;
-			this->onSaveStateChange();
+			if (this->progressChannel.publishProgress(newProgress)) {
+				this->onSaveStateChange();
+			}
 		} else if (this->verbose) {
 			this->log("cannot show updated save progress - no event handler assigned!", Logger::ERROR);
 		}
@@ -710,24 +740,50 @@ class Model_ListCfg :
 		this->unlock();
 	}
 
+	// all values of the returned snapshot belong to the same update
+	public: std::shared_ptr<Model_ProgressChannel_Snapshot const> getProgressSnapshot() const
+	{
+		return this->progressChannel.get();
+	}
+
 	public: double getProgress() const
 	{
-		return progress;
+		return this->progressChannel.get()->progress;
 	}
 
 	public: std::string getProgress_name() const
 	{
-		return progress_name;
+		return this->progressChannel.get()->name;
 	}
 
 	public: int getProgress_pos() const
 	{
-		return progress_pos;
+		return this->progressChannel.get()->pos;
 	}
 
 	public: int getProgress_max() const
 	{
-		return progress_max;
+		return this->progressChannel.get()->max;
+	}
+
+	// requests another load state change after the notification interval - unless one is already pending
+	public: void deferLoadStateChange()
+	{
+		if (this->onLoadStateChangeDeferred && this->progressChannel.requestTrailingNotification()) {
+			this->onLoadStateChangeDeferred(this->progressChannel.getNotificationInterval());
+		}
+	}
+
+	// returns whether the deferred load state change still has to be shown
+	public: bool takeDeferredLoadStateChange()
+	{
+		return this->progressChannel.takeTrailingNotification();
+	}
+
+	// maximum number of state change notifications per second, 0 = unlimited
+	public: void setProgressFrameRate(int frameRate)
+	{
+		this->progressChannel.frameRate = frameRate;
 	}
 
 	public: void renumerate(bool favorDefaultOrder = true)
@@ -786,17 +842,13 @@ class Model_ListCfg :
 
 	public: bool cfgDirIsClean()
 	{
-		DIR* hGrubCfgDir = opendir(this->env->cfg_dir.c_str());
-		if (hGrubCfgDir){
-			struct dirent *entry;
-			struct stat fileProperties;
-			while ((entry = readdir(hGrubCfgDir))){
-				std::string fname = entry->d_name;
-				if ((fname.length() >= 4 && fname.substr(0,3) == "LS_") || fname.substr(0,3) == "PS_" || fname.substr(0,3) == "DS_")
-					return false;
-			}
-			closedir(hGrubCfgDir);
+		Model_ScriptDirectory scan;
+		scan.load(this->env->cfg_dir);
+		if (scan.hasForwarders()) {
+			return false;
 		}
+		std::lock_guard<std::mutex> lock(this->cfgDirScanMutex);
+		this->cfgDirScan = std::move(scan); // nothing to clean up - load() can use it
 		return true;
 	}
 
@@ -861,6 +913,7 @@ class Model_ListCfg :
 	
 	public: bool compare(Model_ListCfg const& other) const
 	{
+		Profiler_Scope compareTimer("compare", "ListCfg");
 		std::array<std::list<std::shared_ptr<Model_Rule>>, 2> rlist;
 		for (int i = 0; i < 2; i++){
 			const Model_ListCfg* gc = i == 0 ? this : &other;
@@ -951,16 +1004,10 @@ class Model_ListCfg :
 		return output;
 	}
 
+	// stderr of the last mkconfig run
 	public: std::string getGrubErrorMessage() const
 	{
-		FILE* errorLogFile = fopen(this->errorLogFile.c_str(), "r");
-		std::string errorMessage;
-		int c;
-		while ((c = fgetc(errorLogFile)) != EOF) {
-			errorMessage += char(c);
-		}
-		fclose(errorLogFile);
-		return errorMessage;
+		return this->mkconfigErrorOutput;
 	}
 
 
@@ -1314,11 +1361,13 @@ class Model_ListCfg :
 		ArrayStructure result;
 		result["proxies"] = ArrayStructure(this->proxies);
 		result["repository"] = ArrayStructure(this->repository);
-		result["progress"] = this->progress;
-		result["progress_name"] = this->progress_name;
-		result["progress_pos"] = this->progress_pos;
-		result["progress_max"] = this->progress_max;
-		result["errorLogFile"] = this->errorLogFile;
+		auto progress = this->progressChannel.get();
+		result["progress"] = progress->progress;
+		result["progress_name"] = progress->name;
+		result["progress_pos"] = progress->pos;
+		result["progress_max"] = progress->max;
+		result["mkconfigTimeout"] = this->mkconfigTimeout;
+		result["updateTimeout"] = this->updateTimeout;
 		result["verbose"] = this->verbose;
 		result["error_proxy_not_found"] = this->error_proxy_not_found;
 		if (this->env) {
@@ -1327,7 +1376,7 @@ class Model_ListCfg :
 			result["env"] = ArrayStructureItem(NULL);
 		}
 		result["ignoreLock"] = this->ignoreLock;
-		result["cancelThreadsRequested"] = this->cancelThreadsRequested;
+		result["cancelThreadsRequested"] = this->cancelThreadsRequested.load();
 		return result;
 	}
 };
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef PROGRESS_CHANNEL_H_INCLUDED
+#define PROGRESS_CHANNEL_H_INCLUDED
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+struct Model_ProgressChannel_Snapshot {
+	double progress;
+	std::string name; // name of the script being processed
+	int pos, max;
+};
+
+/**
+ * passes progress information from a worker thread to the gui
+ *
+ * Every update publishes a new immutable snapshot by swapping a shared pointer
+ * atomically, so readers always get consistent values without locking the writer.
+ * publish() returns whether the gui should be notified - intermediate updates are
+ * limited to frameRate per second, the first (0) and the last (1) one always pass.
+ * A suppressed update must still be shown if no further one follows, so the publisher
+ * schedules one trailing notification per suppressed period (see requestTrailingNotification).
+ */
+class Model_ProgressChannel
+{
+	private: std::shared_ptr<Model_ProgressChannel_Snapshot const> current;
+	private: std::atomic<long long> lastNotification; // steady clock, nanoseconds
+	private: std::atomic<bool> trailingNotificationPending;
+	public: std::atomic<int> frameRate; // 0 = unlimited
+
+	public: Model_ProgressChannel(int frameRate = 0) :
+		current(std::make_shared<Model_ProgressChannel_Snapshot const>(Model_ProgressChannel_Snapshot{0, "", 0, 0})),
+		lastNotification(0),
+		trailingNotificationPending(false),
+		frameRate(frameRate)
+	{}
+
+	public: bool publish(double progress, std::string const& name = "", int pos = 0, int max = 0)
+	{
+		std::atomic_store(
+			&this->current,
+			std::make_shared<Model_ProgressChannel_Snapshot const>(Model_ProgressChannel_Snapshot{progress, name, pos, max})
+		);
+		return this->acquireNotification(progress == 0 || progress == 1);
+	}
+
+	// keeps the script information of the current snapshot
+	public: bool publishProgress(double progress)
+	{
+		auto previous = this->get();
+		return this->publish(progress, previous->name, previous->pos, previous->max);
+	}
+
+	/**
+	 * to be called when publish() returned false
+	 * returns true if the caller has to schedule a trailing notification - false if one is already pending
+	 */
+	public: bool requestTrailingNotification()
+	{
+		return !this->trailingNotificationPending.exchange(true);
+	}
+
+	/**
+	 * to be called by the scheduled trailing notification
+	 * returns false if a regular notification has shown the latest snapshot meanwhile
+	 */
+	public: bool takeTrailingNotification()
+	{
+		return this->trailingNotificationPending.exchange(false);
+	}
+
+	// minimum time between two notifications
+	public: int getNotificationInterval() const
+	{
+		int frameRate = this->frameRate;
+		return frameRate > 0 ? 1000 / frameRate : 0;
+	}
+
+	public: std::shared_ptr<Model_ProgressChannel_Snapshot const> get() const
+	{
+		return std::atomic_load(&this->current);
+	}
+
+	private: bool acquireNotification(bool force)
+	{
+		long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+		long long last = this->lastNotification.load();
+		if (!force && this->frameRate > 0 && now - last < 1000000000LL / this->frameRate) {
+			return false;
+		}
+		// another writer may have notified in the meantime
+		if (this->lastNotification.compare_exchange_strong(last, now) || force) {
+			this->trailingNotificationPending = false; // the notification shows the latest snapshot
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif
@@ -24,6 +24,9 @@
 struct Model_ProxyScriptData {
 	std::string scriptCmd, proxyCmd, ruleString;
 	bool is_valid;
+	Model_ProxyScriptData() : is_valid(false)
+	{}
+
 	Model_ProxyScriptData(FILE* fpProxyScript) : is_valid(false)
 	{
 		load(fpProxyScript);
@@ -160,7 +163,7 @@ struct Model_ProxyScriptData {
 		return result;
 	}
 
-	operator bool() {
+	operator bool() const {
 		return is_valid;
 	}
 };
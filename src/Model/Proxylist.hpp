@@ -128,16 +128,22 @@ class Model_Proxylist : public std::list<std::shared_ptr<Model_Proxy>>, public T
 	public: void deleteProxy(std::shared_ptr<Model_Proxy> proxyPointer) {
 		for (auto proxyIter = this->begin(); proxyIter != this->end(); proxyIter++) {
 			if (*proxyIter == proxyPointer){
-				//if the file must be deleted when saving, move it to trash
-				if (proxyPointer->fileName != "" && proxyPointer->dataSource && proxyPointer->fileName != proxyPointer->dataSource->fileName)
-					this->trash.push_back(proxyPointer);
-				//remove the proxy object
-				this->erase(proxyIter);
+				this->deleteProxy(proxyIter);
 				break;
 			}
 		}
 	}
 
+	// @return iterator to the next proxy
+	public: std::list<std::shared_ptr<Model_Proxy>>::iterator deleteProxy(std::list<std::shared_ptr<Model_Proxy>>::iterator proxyIter) {
+		auto proxyPointer = *proxyIter;
+		//if the file must be deleted when saving, move it to trash
+		if (proxyPointer->fileName != "" && proxyPointer->dataSource && proxyPointer->fileName != proxyPointer->dataSource->fileName)
+			this->trash.push_back(proxyPointer);
+		//remove the proxy object
+		return this->erase(proxyIter);
+	}
+
 	public: void clearTrash()
 	{
 		for (auto trashedProxy : this->trash){
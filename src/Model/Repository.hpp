@@ -28,6 +28,7 @@
 #include "ProxyScriptData.hpp"
 #include "PscriptnameTranslator.hpp"
 #include "Script.hpp"
+#include "ScriptDirectory.hpp"
 
 class Model_Repository : public std::list<std::shared_ptr<Model_Script>>, public Trait_LoggerAware
 {
@@ -35,27 +36,29 @@ class Model_Repository : public std::list<std::shared_ptr<Model_Script>>, public
 
 	public: void load(std::string const& directory, bool is_proxifiedScript_dir)
 	{
-		DIR* dir = opendir(directory.c_str());
-		if (dir){
-			struct dirent *entry;
-			struct stat fileProperties;
-			while ((entry = readdir(dir))) {
-				stat((directory+"/"+entry->d_name).c_str(), &fileProperties);
-				if ((fileProperties.st_mode & S_IFMT) != S_IFDIR){ //ignore directories
-					bool scriptAdded = false;
-					if (!is_proxifiedScript_dir && !Model_ProxyScriptData::is_proxyscript(directory+"/"+entry->d_name) && std::string(entry->d_name).length() >= 4 && entry->d_name[0] >= '0' && entry->d_name[0] <= '9' && entry->d_name[1] >= '0' && entry->d_name[1] <= '9' && entry->d_name[2] == '_'){
-						this->push_back(std::make_shared<Model_Script>(std::string(entry->d_name).substr(3), directory+"/"+entry->d_name));
-						scriptAdded = true;
-					} else if (is_proxifiedScript_dir) {
-						this->push_back(std::make_shared<Model_Script>(Model_PscriptnameTranslator::decode(entry->d_name), directory+"/"+entry->d_name));
-						scriptAdded = true;
-					}
-					if (scriptAdded && this->hasLogger()) {
-						this->back()->setLogger(this->getLogger());
-					}
-				}
+		Model_ScriptDirectory scriptDirectory;
+		if (scriptDirectory.load(directory)) {
+			this->load(scriptDirectory, is_proxifiedScript_dir);
+		}
+	}
+
+	public: void load(Model_ScriptDirectory const& scriptDirectory, bool is_proxifiedScript_dir)
+	{
+		for (auto& file : scriptDirectory.files) {
+			std::string const& name = file.name;
+			std::string path = scriptDirectory.path + "/" + name;
+			bool isCustomScript = file.type == Model_ScriptDirectory_File::CUSTOM_SCRIPT;
+			bool scriptAdded = false;
+			if (!is_proxifiedScript_dir && file.type != Model_ScriptDirectory_File::PROXY && name.length() >= 4 && name[0] >= '0' && name[0] <= '9' && name[1] >= '0' && name[1] <= '9' && name[2] == '_'){
+				this->push_back(std::make_shared<Model_Script>(name.substr(3), path, isCustomScript));
+				scriptAdded = true;
+			} else if (is_proxifiedScript_dir) {
+				this->push_back(std::make_shared<Model_Script>(Model_PscriptnameTranslator::decode(name), path, isCustomScript));
+				scriptAdded = true;
+			}
+			if (scriptAdded && this->hasLogger()) {
+				this->back()->setLogger(this->getLogger());
 			}
-			closedir(dir);
 		}
 	}
 
@@ -53,6 +53,14 @@ class Model_Script : public Model_EntryPathFollower, public Trait_LoggerAware, p
 		}
 	}
 
+	// for scripts which have already been classified by Model_ScriptDirectory
+	public: Model_Script(std::string const& name, std::string const& fileName, bool isCustomScript) :
+		name(name),
+		fileName(fileName),
+		root(std::make_shared<Model_Entry>("DUMMY", "DUMMY", "DUMMY", Model_Entry::SCRIPT_ROOT)),
+		isCustomScript(isCustomScript)
+	{}
+
 	public: bool isModified(std::shared_ptr<Model_Entry> parent = nullptr)
 	{
 		if (!parent) {
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef SCRIPT_DIRECTORY_H_INCLUDED
+#define SCRIPT_DIRECTORY_H_INCLUDED
+#include <string>
+#include <list>
+#include <cstdio>
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../config.hpp"
+#include "ProxyScriptData.hpp"
+
+struct Model_ScriptDirectory_File {
+	enum Type {
+		SCRIPT,
+		PROXY,
+		CUSTOM_SCRIPT,
+		FORWARDER // LS_, PS_ or DS_ file created while loading
+	};
+	std::string name;
+	Type type;
+	mode_t permissions;
+	Model_ProxyScriptData proxyData; // only set for proxies
+	// to detect changes made after loading - in place edits and chmod don't touch the directory
+	struct timespec modificationTime, changeTime;
+};
+
+/**
+ * lists the files of a script directory (like /etc/grub.d)
+ *
+ * The directory is read once and each file is opened relative to the directory fd,
+ * so the path has to be resolved only once (matters for chroots on network mounts).
+ * A single read of the file header decides about the type and contains the
+ * data of generated proxies.
+ */
+class Model_ScriptDirectory
+{
+	public: std::string path;
+	public: std::list<Model_ScriptDirectory_File> files;
+	private: struct timespec modificationTime;
+	private: bool loaded;
+
+	public: Model_ScriptDirectory() : modificationTime(), loaded(false)
+	{}
+
+	public: bool load(std::string const& path)
+	{
+		this->path = path;
+		this->files.clear();
+		this->loaded = false;
+
+		int dirFd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (dirFd == -1) {
+			return false;
+		}
+		struct stat dirProperties;
+		DIR* dir = fdopendir(dirFd);
+		if (!dir || fstat(dirFd, &dirProperties) != 0) {
+			dir ? closedir(dir) : close(dirFd);
+			return false;
+		}
+		this->modificationTime = dirProperties.st_mtim;
+
+		struct dirent* entry;
+		while ((entry = readdir(dir))) {
+			if (entry->d_type == DT_DIR) {
+				continue;
+			}
+			std::string name = entry->d_name;
+			if (name == "." || name == "..") {
+				continue;
+			}
+			Model_ScriptDirectory_File file;
+			if (this->readFile(dirFd, name, file)) {
+				this->files.push_back(file);
+			}
+		}
+		closedir(dir);
+		this->loaded = true;
+		return true;
+	}
+
+	/**
+	 * false if the directory has been changed (files added, removed or renamed) or
+	 * any of the files has been modified or got other permissions since loading
+	 */
+	public: bool isUpToDate() const
+	{
+		if (!this->loaded) {
+			return false;
+		}
+		int dirFd = open(this->path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (dirFd == -1) {
+			return false;
+		}
+		struct stat properties;
+		bool upToDate = fstat(dirFd, &properties) == 0 && isSameTime(properties.st_mtim, this->modificationTime);
+		for (auto fileIter = this->files.begin(); upToDate && fileIter != this->files.end(); fileIter++) {
+			upToDate = fstatat(dirFd, fileIter->name.c_str(), &properties, 0) == 0
+				&& (properties.st_mode & ~S_IFMT) == fileIter->permissions
+				&& isSameTime(properties.st_mtim, fileIter->modificationTime)
+				&& isSameTime(properties.st_ctim, fileIter->changeTime);
+		}
+		close(dirFd);
+		return upToDate;
+	}
+
+	public: bool isLoaded() const
+	{
+		return this->loaded;
+	}
+
+	public: bool hasForwarders() const
+	{
+		for (auto& file : this->files) {
+			if (file.type == Model_ScriptDirectory_File::FORWARDER) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	private: static bool isSameTime(struct timespec const& a, struct timespec const& b)
+	{
+		return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+	}
+
+	public: static bool isForwarderName(std::string const& name)
+	{
+		std::string prefix = name.substr(0, 3);
+		return name.length() >= 4 && (prefix == "LS_" || prefix == "PS_" || prefix == "DS_");
+	}
+
+	private: bool readFile(int dirFd, std::string const& name, Model_ScriptDirectory_File& file)
+	{
+		file.name = name;
+
+		int fd = openat(dirFd, name.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY | O_NONBLOCK);
+		struct stat fileProperties;
+		if (fd == -1) {
+			// unreadable files are listed anyway (like before) - they just can't be classified
+			if (fstatat(dirFd, name.c_str(), &fileProperties, 0) != 0 || S_ISDIR(fileProperties.st_mode)) {
+				return false;
+			}
+			file.permissions = fileProperties.st_mode & ~S_IFMT;
+			file.modificationTime = fileProperties.st_mtim;
+			file.changeTime = fileProperties.st_ctim;
+			file.type = isForwarderName(name) ? Model_ScriptDirectory_File::FORWARDER : Model_ScriptDirectory_File::SCRIPT;
+			return true;
+		}
+		if (fstat(fd, &fileProperties) != 0 || S_ISDIR(fileProperties.st_mode)) {
+			close(fd);
+			return false;
+		}
+		file.permissions = fileProperties.st_mode & ~S_IFMT;
+		file.modificationTime = fileProperties.st_mtim;
+		file.changeTime = fileProperties.st_ctim;
+
+		if (isForwarderName(name)) {
+			file.type = Model_ScriptDirectory_File::FORWARDER;
+			close(fd);
+			return true;
+		}
+
+		std::string header;
+		bool complete = this->readHeader(fd, header, S_ISREG(fileProperties.st_mode) ? 4096 : 0);
+
+		size_t firstLineEnd = header.find('\n');
+		std::string firstLine = header.substr(0, firstLineEnd);
+		std::string secondLine;
+		if (firstLineEnd != std::string::npos) {
+			secondLine = header.substr(firstLineEnd + 1, header.find('\n', firstLineEnd + 1) - firstLineEnd - 1);
+		}
+
+		if (secondLine.compare(0, 28, "#THIS IS A GRUB PROXY SCRIPT") == 0) {
+			file.type = Model_ScriptDirectory_File::PROXY;
+			if (!complete) { // the rule string might be longer than the header
+				this->readHeader(fd, header, fileProperties.st_size);
+			}
+			FILE* proxyFile = fmemopen(const_cast<char*>(header.data()), header.size(), "r");
+			if (proxyFile) {
+				file.proxyData.load(proxyFile);
+				fclose(proxyFile);
+			}
+		} else if (firstLine == CUSTOM_SCRIPT_SHEBANG && secondLine == CUSTOM_SCRIPT_PREFIX) {
+			file.type = Model_ScriptDirectory_File::CUSTOM_SCRIPT;
+		} else {
+			file.type = Model_ScriptDirectory_File::SCRIPT;
+		}
+		close(fd);
+		return true;
+	}
+
+	/**
+	 * appends up to maxSize - header.size() bytes
+	 * @return whether the end of the file has been reached
+	 */
+	private: bool readHeader(int fd, std::string& header, off_t maxSize)
+	{
+		char buffer[4096];
+		while (header.size() < static_cast<size_t>(maxSize)) {
+			ssize_t count = read(fd, buffer, std::min(sizeof(buffer), static_cast<size_t>(maxSize) - header.size()));
+			if (count <= 0) {
+				return true;
+			}
+			header.append(buffer, count);
+		}
+		return false;
+	}
+};
+
+#endif
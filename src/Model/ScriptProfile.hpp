@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef SCRIPT_PROFILE_H_INCLUDED
+#define SCRIPT_PROFILE_H_INCLUDED
+#include <string>
+#include <list>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include "../config.hpp"
+#include "../lib/Trait/LoggerAware.hpp"
+#include "../lib/FileSystem.hpp"
+
+struct Model_ScriptProfile_Item {
+	std::string scriptName; // file name of the script
+	std::string forwarderName;
+	double wallTime; // seconds from BEGIN to END marker of the mkconfig output
+	double userTime; // CPU times of the script and its children, reported by the forwarder
+	double systemTime;
+	long outputSize;
+	std::chrono::steady_clock::time_point startTime;
+};
+
+/**
+ * measures the /etc/grub.d scripts while running mkconfig
+ *
+ * Each script is executed by a profiling forwarder (LS_ file), which captures the
+ * output and records the CPU times using the shell builtin "times". The wall time
+ * is taken from the BEGIN/END markers while reading the mkconfig output.
+ */
+class Model_ScriptProfile :
+	public Trait_LoggerAware
+{
+	public: std::list<Model_ScriptProfile_Item> items;
+	public: std::string workDirTemplate; // mkdtemp template, relative to cfg_dir_prefix - the forwarders may run inside of a chroot
+	public: std::string logFile;
+	private: std::string workDir; // private directory created by start()
+	private: bool running;
+	private: std::string rootPrefix;
+
+	public: Model_ScriptProfile() :
+		workDirTemplate("/tmp/grub-customizer_script_profile.XXXXXX"), logFile(SCRIPT_PROFILE_FILE), running(false)
+	{}
+
+	/**
+	 * creates a new private (0700) work directory for the forwarder output
+	 */
+	public: void start(std::string const& rootPrefix)
+	{
+		this->rootPrefix = rootPrefix;
+		this->items.clear();
+		std::string path = this->rootPrefix + this->workDirTemplate;
+		if (mkdtemp(&path[0]) == NULL) {
+			throw FileSaveException("cannot create the script profile directory " + path, __FILE__, __LINE__);
+		}
+		this->workDir = path.substr(this->rootPrefix.length());
+		this->running = true;
+	}
+
+	public: bool isRunning() const
+	{
+		return this->running;
+	}
+
+	/**
+	 * @param scriptPath path inside of the root
+	 * @param interpreter quoted interpreter command, empty if the script is executable itself
+	 */
+	public: std::string buildForwarder(std::string const& scriptPath, std::string const& interpreter, std::string const& forwarderName) const
+	{
+		std::string outputFile = "'" + this->workDir + "/" + forwarderName + ".out'";
+		std::string timesFile = "'" + this->workDir + "/" + forwarderName + ".times'";
+		return
+			"#!/bin/sh\n"
+			"script='" + scriptPath + "'\n" +
+			(interpreter != "" ? interpreter + " " : "") + "\"$script\" > " + outputFile + "\n"
+			"result=$?\n"
+			"times > " + timesFile + "\n"
+			"cat " + outputFile + "\n"
+			"exit $result\n";
+	}
+
+	/**
+	 * builds the (quoted) interpreter call from the shebang of the given script
+	 */
+	public: static std::string readInterpreter(std::string const& scriptFile)
+	{
+		std::ifstream script(scriptFile.c_str());
+		std::string firstRow;
+		std::getline(script, firstRow);
+		if (firstRow.substr(0, 2) != "#!") {
+			return "'/bin/sh'";
+		}
+		std::istringstream tokens(firstRow.substr(2));
+		std::string token, result;
+		while (tokens >> token) {
+			result += (result != "" ? " '" : "'") + token + "'";
+		}
+		return result != "" ? result : "'/bin/sh'";
+	}
+
+	public: void begin(std::string const& scriptName, std::string const& forwarderName)
+	{
+		this->end();
+		Model_ScriptProfile_Item item;
+		item.scriptName = scriptName;
+		item.forwarderName = forwarderName;
+		item.wallTime = -1;
+		item.userTime = 0;
+		item.systemTime = 0;
+		item.outputSize = 0;
+		item.startTime = std::chrono::steady_clock::now();
+		this->items.push_back(item);
+	}
+
+	public: void end()
+	{
+		if (this->items.size() && this->items.back().wallTime == -1) {
+			this->items.back().wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->items.back().startTime).count();
+		}
+	}
+
+	/**
+	 * collects the data written by the forwarders, writes the log file and cleans up
+	 */
+	public: void finish()
+	{
+		this->end();
+		for (auto& item : this->items) {
+			std::string basePath = this->rootPrefix + this->workDir + "/" + item.forwarderName;
+			FILE* timesFile = fopen((basePath + ".times").c_str(), "r");
+			if (timesFile) {
+				Model_ScriptProfile::parseTimes(timesFile, item.userTime, item.systemTime);
+				fclose(timesFile);
+			}
+			struct stat fileProperties;
+			if (stat((basePath + ".out").c_str(), &fileProperties) == 0) {
+				item.outputSize = fileProperties.st_size;
+			}
+
+			std::ostringstream message;
+			message << "script " << item.scriptName << ": " << item.wallTime << "s wall, "
+			        << item.userTime << "s user, " << item.systemTime << "s system, " << item.outputSize << " bytes";
+			this->log(message.str(), Logger::INFO);
+		}
+		try {
+			FileSystem().rmdirRecursive(this->rootPrefix + this->workDir);
+		} catch (FileReadException const& e) {
+			this->log("cannot remove " + this->workDir, Logger::ERROR);
+		}
+
+		std::ostringstream log;
+		log << "script\twall_s\tuser_s\tsystem_s\toutput_bytes\n";
+		for (auto& item : this->items) {
+			log << item.scriptName << "\t" << item.wallTime << "\t" << item.userTime << "\t" << item.systemTime << "\t" << item.outputSize << "\n";
+		}
+		try {
+			FileSystem().writeExclusive(this->logFile, log.str());
+			this->log("script profile written to " + this->logFile, Logger::IMPORTANT_EVENT);
+		} catch (FileSaveException const& e) {
+			this->log("cannot write script profile to " + this->logFile, Logger::ERROR);
+		}
+		this->running = false;
+	}
+
+	public: Model_ScriptProfile_Item const* getSlowest() const
+	{
+		Model_ScriptProfile_Item const* result = NULL;
+		for (auto& item : this->items) {
+			if (result == NULL || item.wallTime > result->wallTime) {
+				result = &item;
+			}
+		}
+		return result;
+	}
+
+	public: double getTotalWallTime() const
+	{
+		double result = 0;
+		for (auto& item : this->items) {
+			result += item.wallTime;
+		}
+		return result;
+	}
+
+	/**
+	 * reads the output of "times" - the second row contains the times of the child processes
+	 * (format: 0m0.004s 0m0.000s)
+	 */
+	public: static bool parseTimes(FILE* source, double& userTime, double& systemTime)
+	{
+		int userMinutes = 0, systemMinutes = 0;
+		double userSeconds = 0, systemSeconds = 0;
+		char row[256];
+		if (fgets(row, sizeof(row), source) && fgets(row, sizeof(row), source)
+			&& sscanf(row, "%dm%lfs %dm%lfs", &userMinutes, &userSeconds, &systemMinutes, &systemSeconds) == 4) {
+			userTime = userMinutes * 60 + userSeconds;
+			systemTime = systemMinutes * 60 + systemSeconds;
+			return true;
+		}
+		return false;
+	}
+};
+
+#endif
@@ -20,6 +20,7 @@
 #define SMARTFILEHANDLE_H_
 #include <cstdio>
 #include <string>
+#include <algorithm>
 #include "../lib/Exception.hpp"
 
 class Model_SmartFileHandle {
@@ -32,70 +33,109 @@ public:
 private:
 	FILE* proc_or_file;
 	Model_SmartFileHandle::Type type;
-	std::string string; // content for TYPE_STRING
+	// content which has been read but not consumed yet - the whole content for TYPE_STRING
+	std::string buffer;
+	size_t cursor;
+	bool sourceDrained; // true if the file/cmd won't deliver more data
+
+	static const size_t BLOCK_SIZE = 4096;
+
+	// appends the next block of the file/cmd output to the buffer, returns false if nothing has been added
+	bool fillBuffer() {
+		if (this->sourceDrained) {
+			return false;
+		}
+		// drop consumed content before growing the buffer
+		if (this->cursor > 0 && this->cursor >= this->buffer.size() / 2) {
+			this->buffer.erase(0, this->cursor);
+			this->cursor = 0;
+		}
+		char block[BLOCK_SIZE];
+		size_t size = fread(block, 1, BLOCK_SIZE, this->proc_or_file);
+		if (size < BLOCK_SIZE) {
+			this->sourceDrained = true;
+		}
+		this->buffer.append(block, size);
+		return size > 0;
+	}
 public:
-	Model_SmartFileHandle() : type(TYPE_STRING), proc_or_file(NULL)
+	Model_SmartFileHandle() : type(TYPE_STRING), proc_or_file(NULL), cursor(0), sourceDrained(true)
 	{
 	}
 
-	char getChar() {
-		if (type == TYPE_STRING) {
-			if (this->string.size()) {
-				int c = (int) this->string[0];
-				this->string = this->string.substr(1);
-				return c;
-			} else {
-				throw EndOfFileException("end of file", __FILE__, __LINE__);
+	// true if all content has been consumed
+	bool isEof() {
+		return this->cursor == this->buffer.size() && !this->fillBuffer();
+	}
+
+	// reads the next row without the line break, returns false at end of file
+	bool readRow(std::string& row) {
+		size_t searchOffset = 0; // relative to the cursor - fillBuffer may move the content
+		size_t rowEnd;
+		while ((rowEnd = this->buffer.find('\n', this->cursor + searchOffset)) == std::string::npos) {
+			searchOffset = this->buffer.size() - this->cursor;
+			if (!this->fillBuffer()) {
+				break;
 			}
-		} else {
-			int c = fgetc(this->proc_or_file);
-			if (c != EOF)
-				return c;
-			else
-				throw EndOfFileException("end of file", __FILE__, __LINE__);
 		}
+		if (rowEnd == std::string::npos) {
+			if (this->cursor == this->buffer.size()) {
+				return false;
+			}
+			rowEnd = this->buffer.size();
+		}
+		row.assign(this->buffer, this->cursor, rowEnd - this->cursor);
+		this->cursor = std::min(rowEnd + 1, this->buffer.size());
+		return true;
+	}
+
+	// reads the whole remaining content, returns false at end of file
+	bool readAll(std::string& content) {
+		while (this->fillBuffer()) {
+		}
+		if (this->cursor == this->buffer.size()) {
+			return false;
+		}
+		content.assign(this->buffer, this->cursor, std::string::npos);
+		this->cursor = this->buffer.size();
+		return true;
+	}
+
+	char getChar() {
+		if (this->isEof()) {
+			throw EndOfFileException("end of file", __FILE__, __LINE__);
+		}
+		return this->buffer[this->cursor++];
 	}
 
 	std::string getRow() {
 		std::string result;
-		int c;
-		try {
-			while ((c = this->getChar()) != EOF && c != '\n'){
-				result += c;
-			}
-		} catch (EndOfFileException const& e) {
-			if (result == "") {
-				throw e;
-			}
+		if (!this->readRow(result)) {
+			throw EndOfFileException("end of file", __FILE__, __LINE__);
 		}
 		return result;
 	}
 
 	std::string getAll() {
 		std::string result;
-		int c;
-		try {
-			while ((c = this->getChar()) != EOF){
-				result += c;
-			}
-		} catch (EndOfFileException const& e) {
-			if (result == "") {
-				throw e;
-			}
+		if (!this->readAll(result)) {
+			throw EndOfFileException("end of file", __FILE__, __LINE__);
 		}
 		return result;
 	}
 
 	void open(std::string const& cmd_or_file, std::string const& mode, Type type) {
-		if (this->proc_or_file || this->string != "")
+		if (this->proc_or_file || this->buffer != "")
 			throw HandleNotClosedException("handle not closed - cannot open", __FILE__, __LINE__);
 	
 		this->proc_or_file = NULL;
-		this->string = "";
+		this->buffer = "";
+		this->cursor = 0;
+		this->sourceDrained = type == TYPE_STRING;
 	
 		switch (type) {
 			case TYPE_STRING:
-				this->string = cmd_or_file;
+				this->buffer = cmd_or_file;
 				break;
 			case TYPE_COMMAND:
 				this->proc_or_file = popen(cmd_or_file.c_str(), mode.c_str());
@@ -119,7 +159,6 @@ public:
 	
 		switch (type) {
 			case TYPE_STRING:
-				this->string = "";
 				break;
 			case TYPE_COMMAND:
 				pclose(this->proc_or_file);
@@ -130,6 +169,10 @@ public:
 			default:
 				throw LogicException("unexpected type given");
 		}
+		this->proc_or_file = NULL;
+		this->buffer = "";
+		this->cursor = 0;
+		this->sourceDrained = true;
 	}
 
 };
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef ICONCACHE_H_
+#define ICONCACHE_H_
+#include <gtkmm.h>
+#include <map>
+#include <utility>
+
+/**
+ * stock icons rendered for list rows - they are identical for all rows of the
+ * same type, so all lists share them. The cache is dropped when the icon theme changes.
+ */
+class View_Gtk_Element_IconCache
+{
+	private: std::map<std::pair<Glib::ustring, int>, Glib::RefPtr<Gdk::Pixbuf> > icons;
+
+	public: static View_Gtk_Element_IconCache& getInstance()
+	{
+		static View_Gtk_Element_IconCache cache;
+
+		return cache;
+	}
+
+	private: View_Gtk_Element_IconCache()
+	{
+		Gtk::IconTheme::get_default()->signal_changed().connect(sigc::mem_fun(this, &View_Gtk_Element_IconCache::clear));
+	}
+
+	public: Glib::RefPtr<Gdk::Pixbuf> get(Gtk::Widget& widget, Gtk::StockID const& stockId, Gtk::IconSize size)
+	{
+		std::pair<Glib::ustring, int> key(stockId.get_string(), int(size));
+		std::map<std::pair<Glib::ustring, int>, Glib::RefPtr<Gdk::Pixbuf> >::iterator iter = this->icons.find(key);
+		if (iter != this->icons.end()) {
+			return iter->second;
+		}
+		Glib::RefPtr<Gdk::Pixbuf> icon = widget.render_icon_pixbuf(stockId, size);
+		this->icons[key] = icon;
+		return icon;
+	}
+
+	public: void clear()
+	{
+		this->icons.clear();
+	}
+};
+
+#endif /* ICONCACHE_H_ */
@@ -23,8 +23,19 @@
 #include "../../../lib/Exception.hpp"
 #include "../../Model/ListItem.hpp"
 #include "../../../lib/Helper.hpp"
+#include "IconCache.hpp"
 #include <libintl.h>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
+/**
+ * Rows are copies of the list items passed by the controllers, kept in a Gtk::TreeStore.
+ * Views don't know Model_* objects, so the store isn't replaced by a TreeModel reading
+ * Model_Proxylist directly. Instead list updates are reconciled against the existing rows,
+ * so only changed rows cause work in GTK.
+ */
 template<typename TItem, typename TWrapper>
 class View_Gtk_Element_List :
 	public Gtk::TreeView
@@ -44,7 +55,7 @@ class View_Gtk_Element_List :
 		Gtk::TreeModelColumn<bool> is_activated;
 		Gtk::TreeModelColumn<bool> is_toplevel;
 		Gtk::TreeModelColumn<Pango::EllipsizeMode> ellipsize;
-		Gtk::TreeModelColumn<Glib::RefPtr<Gdk::Pixbuf> > icon;
+		Gtk::TreeModelColumn<int> iconType;
 
 		TreeModel()
 		{
@@ -59,7 +70,7 @@ class View_Gtk_Element_List :
 			this->add(is_activated);
 			this->add(is_sensitive);
 			this->add(is_toplevel);
-			this->add(icon);
+			this->add(iconType);
 			this->add(ellipsize);
 		}
 	};
@@ -71,15 +82,36 @@ class View_Gtk_Element_List :
 	public: Gtk::TreeViewColumn mainColumn;
 	public: Pango::EllipsizeMode ellipsizeMode;
 
+	public: enum IconType {
+		ICON_SCRIPT,
+		ICON_SUBMENU,
+		ICON_PLACEHOLDER,
+		ICON_ENTRY
+	};
+	// rows only store the icon type - pixbufs are taken from the shared icon cache when a row gets drawn
+	private: Gtk::IconSize iconSize;
+
+	// rows are identified by the rule (or script) they represent
+	private: typedef std::pair<TItem*, TWrapper*> RowKey;
+	private: bool updateRunning;
+	private: std::map<RowKey, int> reconciledChildCount;
+	private: std::set<RowKey> reconciledRows;
+
+	// row lookup by rule/script - references stay valid while rows are moved around
+	private: std::unordered_map<TItem*, Gtk::TreeRowReference> ruleRows;
+	private: std::unordered_map<TWrapper*, Gtk::TreeRowReference> scriptRows;
+
 	public:	View_Gtk_Element_List() :
-		ellipsizeMode(Pango::ELLIPSIZE_NONE)
+		ellipsizeMode(Pango::ELLIPSIZE_NONE),
+		iconSize(Gtk::ICON_SIZE_MENU),
+		updateRunning(false)
 	{
 		refTreeStore = Gtk::TreeStore::create(treeModel);
 		this->set_model(refTreeStore);
 
 		this->append_column(this->mainColumn);
 		this->mainColumn.pack_start(pixbufRenderer, false);
-		this->mainColumn.add_attribute(pixbufRenderer.property_pixbuf(), treeModel.icon);
+		this->mainColumn.set_cell_data_func(pixbufRenderer, sigc::mem_fun(this, &View_Gtk_Element_List::renderIcon));
 		this->mainColumn.pack_start(toggleRenderer, false);
 		this->mainColumn.add_attribute(toggleRenderer.property_sensitive(), treeModel.is_sensitive);
 		toggleRenderer.set_visible(false);
@@ -94,12 +126,13 @@ class View_Gtk_Element_List :
 		this->set_headers_visible(false);
 		this->get_selection()->set_mode(Gtk::SELECTION_MULTIPLE);
 		this->set_rubber_banding(true);
+
+		this->signal_style_updated().connect(sigc::mem_fun(this, &View_Gtk_Element_List::on_style_changed_clear_icons));
 	}
 
 	public:	void addListItem(
 		View_Model_ListItem<TItem, TWrapper> const& listItem,
-		std::map<ViewOption, bool> const& options,
-		Gtk::Window& window
+		std::map<ViewOption, bool> const& options
 	)
 	{
 		if (!listItem.isVisible && !options.at(VIEW_SHOW_HIDDEN_ENTRIES)) {
@@ -112,7 +145,19 @@ class View_Gtk_Element_List :
 			return;
 		}
 		Gtk::TreeIter entryRow;
-		if (listItem.parentEntry) {
+		bool isNewRow = true;
+		if (this->updateRunning) {
+			RowKey parentKey(NULL, NULL);
+			if (listItem.parentEntry) {
+				parentKey.first = listItem.parentEntry;
+			} else if (listItem.parentScript && options.at(VIEW_GROUP_BY_SCRIPT)) {
+				parentKey.second = listItem.parentScript;
+			}
+			if (parentKey != RowKey(NULL, NULL) && this->reconciledRows.find(parentKey) == this->reconciledRows.end()) {
+				return; // visible entry below a hidden submenu - the parent row may still exist from the previous render
+			}
+			entryRow = this->reconcileRow(parentKey, RowKey(listItem.entryPtr, listItem.scriptPtr), isNewRow);
+		} else if (listItem.parentEntry) {
 			try {
 				entryRow = this->refTreeStore->append(this->getIterByRulePtr(listItem.parentEntry)->children());
 			} catch (ItemNotFoundException const& e) {
@@ -124,7 +169,7 @@ class View_Gtk_Element_List :
 			entryRow = this->refTreeStore->append();
 		}
 
-		Glib::RefPtr<Gdk::Pixbuf> icon;
+		IconType iconType;
 		std::string outputName = Helper::escapeXml(listItem.name);
 		if (!listItem.is_placeholder) {
 			outputName = "<b>" + outputName + "</b>";
@@ -164,57 +209,228 @@ class View_Gtk_Element_List :
 		}
 
 		if (listItem.scriptPtr != NULL) {
-			icon = window.render_icon_pixbuf(Gtk::Stock::FILE, options.at(VIEW_SHOW_DETAILS) ? Gtk::ICON_SIZE_LARGE_TOOLBAR : Gtk::ICON_SIZE_MENU);
+			iconType = ICON_SCRIPT;
 		} else if (listItem.is_submenu) {
-			icon = window.render_icon_pixbuf(Gtk::Stock::DIRECTORY, options.at(VIEW_SHOW_DETAILS) ? Gtk::ICON_SIZE_LARGE_TOOLBAR : Gtk::ICON_SIZE_MENU);
+			iconType = ICON_SUBMENU;
 		} else if (listItem.is_placeholder) {
-			icon = window.render_icon_pixbuf(Gtk::Stock::FIND, options.at(VIEW_SHOW_DETAILS) ? Gtk::ICON_SIZE_LARGE_TOOLBAR : Gtk::ICON_SIZE_MENU);
+			iconType = ICON_PLACEHOLDER;
 		} else {
-			icon = window.render_icon_pixbuf(Gtk::Stock::EXECUTE, options.at(VIEW_SHOW_DETAILS) ? Gtk::ICON_SIZE_LARGE_TOOLBAR : Gtk::ICON_SIZE_MENU);
+			iconType = ICON_ENTRY;
 		}
+		this->setIconSize(options.at(VIEW_SHOW_DETAILS) ? Gtk::ICON_SIZE_LARGE_TOOLBAR : Gtk::ICON_SIZE_MENU);
 
 		if (listItem.isModified) {
 			outputName = "<i>" + outputName + "</i>";
 		}
 
-		(*entryRow)[this->treeModel.name] = listItem.name;
-		(*entryRow)[this->treeModel.text] = outputName;
-		(*entryRow)[this->treeModel.is_activated] = listItem.isVisible;
-		(*entryRow)[this->treeModel.relatedRule] = listItem.entryPtr;
-		(*entryRow)[this->treeModel.relatedScript] = listItem.scriptPtr;
-		(*entryRow)[this->treeModel.is_renamable] = false;
-		(*entryRow)[this->treeModel.is_renamable_real] = !listItem.is_placeholder && listItem.scriptPtr == NULL;
-		(*entryRow)[this->treeModel.is_editable] = listItem.isEditable;
-		(*entryRow)[this->treeModel.is_sensitive] = listItem.scriptPtr == NULL;
-		(*entryRow)[this->treeModel.is_toplevel] = listItem.parentEntry == NULL;
-		(*entryRow)[this->treeModel.icon] = icon;
-		(*entryRow)[this->treeModel.ellipsize] = ellipsizeMode;
+		if (isNewRow) {
+			(*entryRow)[this->treeModel.relatedRule] = listItem.entryPtr;
+			(*entryRow)[this->treeModel.relatedScript] = listItem.scriptPtr;
+			(*entryRow)[this->treeModel.is_renamable] = false;
+			this->registerRow(entryRow, listItem.entryPtr, listItem.scriptPtr);
+		}
+		// only touch changed columns to keep row-changed emissions (and redraws) down
+		this->setIfChanged(entryRow, this->treeModel.name, Glib::ustring(listItem.name));
+		this->setIfChanged(entryRow, this->treeModel.text, Glib::ustring(outputName));
+		this->setIfChanged(entryRow, this->treeModel.is_activated, listItem.isVisible);
+		this->setIfChanged(entryRow, this->treeModel.is_renamable_real, !listItem.is_placeholder && listItem.scriptPtr == NULL);
+		this->setIfChanged(entryRow, this->treeModel.is_editable, listItem.isEditable);
+		this->setIfChanged(entryRow, this->treeModel.is_sensitive, listItem.scriptPtr == NULL);
+		this->setIfChanged(entryRow, this->treeModel.is_toplevel, listItem.parentEntry == NULL);
+		this->setIfChanged(entryRow, this->treeModel.iconType, int(iconType));
+		this->setIfChanged(entryRow, this->treeModel.ellipsize, ellipsizeMode);
 	}
 
-	public:	Gtk::TreeModel::iterator getIterByRulePtr(TItem* rulePtr, const Gtk::TreeRow* parentRow = NULL) const
+	private: void setIconSize(Gtk::IconSize size)
 	{
-		const Gtk::TreeNodeChildren children = parentRow ? parentRow->children() : this->refTreeStore->children();
-		for (Gtk::TreeModel::const_iterator iter = children.begin(); iter != children.end(); iter++) {
-			if ((*iter)[this->treeModel.relatedRule] == rulePtr)
+		if (size != this->iconSize) {
+			this->iconSize = size;
+			this->queue_draw();
+		}
+	}
+
+	private: void renderIcon(Gtk::CellRenderer* renderer, Gtk::TreeModel::iterator const& iter)
+	{
+		int iconType = (*iter)[this->treeModel.iconType];
+		Gtk::StockID stockId;
+		switch (iconType) {
+		case ICON_SCRIPT: stockId = Gtk::Stock::FILE; break;
+		case ICON_SUBMENU: stockId = Gtk::Stock::DIRECTORY; break;
+		case ICON_PLACEHOLDER: stockId = Gtk::Stock::FIND; break;
+		default: stockId = Gtk::Stock::EXECUTE;
+		}
+		static_cast<Gtk::CellRendererPixbuf*>(renderer)->property_pixbuf() = View_Gtk_Element_IconCache::getInstance().get(*this, stockId, this->iconSize);
+	}
+
+	// theme switches (including icon size settings) change the rendered stock icons
+	private: void on_style_changed_clear_icons()
+	{
+		View_Gtk_Element_IconCache::getInstance().clear();
+		this->queue_draw();
+	}
+
+	/**
+	 * starts a keyed update: following addListItem calls are reconciled against
+	 * the rows of the previous render instead of being appended to an empty list
+	 */
+	public:	void beginUpdate()
+	{
+		this->updateRunning = true;
+		this->reconciledChildCount.clear();
+		this->reconciledRows.clear();
+	}
+
+	/**
+	 * finishes a keyed update by removing all rows which haven't been added again
+	 */
+	public:	void endUpdate()
+	{
+		this->removeUnreconciledRows(this->refTreeStore->children(), RowKey(NULL, NULL));
+		this->removeInvalidRowReferences();
+		this->updateRunning = false;
+		this->reconciledChildCount.clear();
+		this->reconciledRows.clear();
+	}
+
+	public:	bool isUpdateRunning() const
+	{
+		return this->updateRunning;
+	}
+
+	/**
+	 * Returns the row to be used for the given key at the next position below the given parent.
+	 * Rows before that position have already been reconciled, so an existing row is searched
+	 * in the remaining siblings only and moved into place. A row using the same key at
+	 * another level (eg. after moving an entry into a submenu) is dropped.
+	 */
+	private: Gtk::TreeIter reconcileRow(RowKey const& parentKey, RowKey const& key, bool& isNewRow)
+	{
+		int pos = this->reconciledChildCount[parentKey]++;
+		this->reconciledRows.insert(key);
+
+		Gtk::TreeNodeChildren children = this->getChildrenByKey(parentKey);
+
+		Gtk::TreeIter insertPos = children.end();
+		if (pos < int(children.size())) {
+			insertPos = children[pos];
+		}
+		for (Gtk::TreeIter iter = insertPos; iter != children.end(); iter++) {
+			if (this->getRowKey(*iter) == key) {
+				if (iter != insertPos) {
+					this->refTreeStore->move(iter, insertPos);
+				}
+				isNewRow = false;
 				return iter;
-			try {
-				return this->getIterByRulePtr(rulePtr, &**iter); //recursively search for the treeview item
-			} catch (ItemNotFoundException const& e) {
-				//(ignore ItemNotFoundException exception)
 			}
 		}
-		throw ItemNotFoundException("rule not found", __FILE__, __LINE__);
+
+		try {
+			Gtk::TreeIter staleRow = key.first ? this->getIterByRulePtr(key.first) : this->getIterByScriptPtr(key.second);
+			this->refTreeStore->erase(staleRow);
+		} catch (ItemNotFoundException const& e) {
+			// the row is really new
+		}
+
+		isNewRow = true;
+		if (insertPos != children.end()) {
+			return this->refTreeStore->insert(insertPos);
+		} else {
+			return this->refTreeStore->append(children);
+		}
 	}
 
-	public:	Gtk::TreeModel::iterator getIterByScriptPtr(TWrapper* scriptPtr) const
+	private: void removeUnreconciledRows(Gtk::TreeNodeChildren const& children, RowKey const& parentKey)
 	{
-		const Gtk::TreeNodeChildren children = this->refTreeStore->children();
-		for (Gtk::TreeModel::const_iterator iter = children.begin(); iter != children.end(); iter++) {
-			if ((*iter)[this->treeModel.relatedScript] == scriptPtr) {
-				return iter;
+		int keep = 0;
+		if (this->reconciledChildCount.find(parentKey) != this->reconciledChildCount.end()) {
+			keep = this->reconciledChildCount[parentKey];
+		}
+		while (int(children.size()) > keep) {
+			this->refTreeStore->erase(children[keep]);
+		}
+		for (Gtk::TreeIter iter = children.begin(); iter != children.end(); iter++) {
+			this->removeUnreconciledRows(iter->children(), this->getRowKey(*iter));
+		}
+	}
+
+	private: Gtk::TreeNodeChildren getChildrenByKey(RowKey const& key) const
+	{
+		if (key.first) {
+			return this->getIterByRulePtr(key.first)->children();
+		} else if (key.second) {
+			return this->getIterByScriptPtr(key.second)->children();
+		} else {
+			return this->refTreeStore->children();
+		}
+	}
+
+	private: RowKey getRowKey(Gtk::TreeRow const& row) const
+	{
+		TItem* rule = row[this->treeModel.relatedRule];
+		TWrapper* script = row[this->treeModel.relatedScript];
+		return RowKey(rule, script);
+	}
+
+	private: template <typename TValue> void setIfChanged(Gtk::TreeIter row, Gtk::TreeModelColumn<TValue> const& column, TValue const& value)
+	{
+		TValue oldValue = (*row)[column];
+		if (!(oldValue == value)) {
+			(*row)[column] = value;
+		}
+	}
+
+	private: void registerRow(Gtk::TreeIter const& row, TItem* rulePtr, TWrapper* scriptPtr)
+	{
+		Gtk::TreeRowReference rowReference(this->refTreeStore, this->refTreeStore->get_path(row));
+		if (rulePtr) {
+			this->ruleRows[rulePtr] = rowReference;
+		} else if (scriptPtr) {
+			this->scriptRows[scriptPtr] = rowReference;
+		}
+	}
+
+	// references of erased rows become invalid - drop them
+	private: void removeInvalidRowReferences()
+	{
+		for (typename std::unordered_map<TItem*, Gtk::TreeRowReference>::iterator iter = this->ruleRows.begin(); iter != this->ruleRows.end();) {
+			if (iter->second.is_valid()) {
+				iter++;
+			} else {
+				iter = this->ruleRows.erase(iter);
 			}
 		}
-		throw ItemNotFoundException("script not found", __FILE__, __LINE__);
+		for (typename std::unordered_map<TWrapper*, Gtk::TreeRowReference>::iterator iter = this->scriptRows.begin(); iter != this->scriptRows.end();) {
+			if (iter->second.is_valid()) {
+				iter++;
+			} else {
+				iter = this->scriptRows.erase(iter);
+			}
+		}
+	}
+
+	public:	void clear()
+	{
+		this->refTreeStore->clear();
+		this->ruleRows.clear();
+		this->scriptRows.clear();
+	}
+
+	public:	Gtk::TreeModel::iterator getIterByRulePtr(TItem* rulePtr) const
+	{
+		typename std::unordered_map<TItem*, Gtk::TreeRowReference>::const_iterator rowIter = this->ruleRows.find(rulePtr);
+		if (rowIter == this->ruleRows.end() || !rowIter->second.is_valid()) {
+			throw ItemNotFoundException("rule not found", __FILE__, __LINE__);
+		}
+		return this->refTreeStore->get_iter(rowIter->second.get_path());
+	}
+
+	public:	Gtk::TreeModel::iterator getIterByScriptPtr(TWrapper* scriptPtr) const
+	{
+		typename std::unordered_map<TWrapper*, Gtk::TreeRowReference>::const_iterator rowIter = this->scriptRows.find(scriptPtr);
+		if (rowIter == this->scriptRows.end() || !rowIter->second.is_valid()) {
+			throw ItemNotFoundException("script not found", __FILE__, __LINE__);
+		}
+		return this->refTreeStore->get_iter(rowIter->second.get_path());
 	}
 
 	public:	void setRuleName(TItem* rule, std::string const& newName)
@@ -22,6 +22,7 @@
 
 #include <gtkmm.h>
 #include <libintl.h>
+#include <iomanip>
 #include "../../config.hpp"
 #include "../../lib/Helper.hpp"
 #include "../../lib/Type.hpp"
@@ -55,6 +56,7 @@ class View_Gtk_Main : public View_Main {
 	private: Gtk::Statusbar statusbar;
 	
 	private: View_Gtk_Element_List<Rule, Proxy> tvConfList;
+	private: double listScrollPosition = 0;
 	private: Gtk::ProgressBar progressBar;
 	private: Gtk::HPaned hpLists;
 	private: Gtk::Widget* trashList = nullptr;
@@ -538,11 +540,37 @@ class View_Gtk_Main : public View_Main {
 		}
 	}
 
+	public: void showScriptProfile(std::string const& slowestScript, double slowestScriptTime, double totalTime)
+	{
+		statusbar.push(Glib::ustring::compose(
+			gettext("slowest script: %1 (%2 of %3 seconds) - see %4"),
+			slowestScript,
+			Glib::ustring::format(std::fixed, std::setprecision(2), slowestScriptTime),
+			Glib::ustring::format(std::fixed, std::setprecision(2), totalTime),
+			SCRIPT_PROFILE_FILE
+		));
+	}
+
+	public: void beginListUpdate()
+	{
+		this->listScrollPosition = this->scrEntryList.get_vadjustment()->get_value();
+		this->tvConfList.beginUpdate();
+	}
+
 	public: void appendEntry(View_Model_ListItem<Rule, Proxy> const& listItem)
 	{
-		this->tvConfList.addListItem(listItem, this->options, this->win);
+		this->tvConfList.addListItem(listItem, this->options);
 
-		tvConfList.expand_all();
+		if (!this->tvConfList.isUpdateRunning()) {
+			tvConfList.expand_all();
+		}
+	}
+
+	public: void endListUpdate()
+	{
+		this->tvConfList.endUpdate();
+		tvConfList.expand_all(); // once per update instead of once per appended row
+		this->scrEntryList.get_vadjustment()->set_value(this->listScrollPosition);
 	}
 
 	public: void showProxyNotFoundMessage()
@@ -636,7 +664,7 @@ class View_Gtk_Main : public View_Main {
 
 	public: void clear()
 	{
-		tvConfList.refTreeStore->clear();
+		tvConfList.clear();
 	}
 
 	public: bool confirmUnsavedSwitch()
@@ -118,7 +118,7 @@ class View_Gtk_Trash :
 	public: void clear()
 	{
 		event_lock = true;
-		list.refTreeStore->clear();
+		list.clear();
 		event_lock = false;
 	}
 
@@ -135,7 +135,7 @@ class View_Gtk_Trash :
 
 	private: void addItem(View_Model_ListItem<Rule, Script> const& listItem)
 	{
-		this->list.addListItem(listItem, this->options, *this);
+		this->list.addListItem(listItem, this->options);
 	}
 
 	private: void setDeleteButtonEnabled(bool val)
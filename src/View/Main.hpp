@@ -90,8 +90,14 @@ public:
 	//sets the text to be showed inside the status bar
 	virtual void setStatusText(std::string const& new_status_text)=0;
 	virtual void setStatusText(std::string const& name, int pos, int max)=0;
+	//shows the slowest grub.d script of a profiled load in the status bar
+	virtual void showScriptProfile(std::string const& slowestScript, double slowestScriptTime, double totalTime)=0;
+	//starts a list update - entries appended until endListUpdate() replace the current list, unchanged rows are kept
+	virtual void beginListUpdate()=0;
 	//add entry to the end of the last script of the list
 	virtual void appendEntry(View_Model_ListItem<Rule, Proxy> const& listItem)=0;
+	//removes the rows which haven't been appended again since beginListUpdate()
+	virtual void endListUpdate()=0;
 	//notifies the user about the problem that no grublistcfg_proxy has been found
 	virtual void showProxyNotFoundMessage()=0;
 	//creates a string for an other entry placeholder
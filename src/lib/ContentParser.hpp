@@ -20,21 +20,27 @@
 #define CONTENTPARSER_H_
 #include <map>
 #include <string>
+#include <list>
 
 #include "Exception.hpp"
+#include "ContentParser/Tokenizer.hpp"
 
+/**
+ * content parsers don't keep any state between calls - all parsing methods are const,
+ * so a single parser instance can be used by multiple threads at the same time
+ */
 class ContentParser {
 public:
 	virtual inline ~ContentParser() {};
-	virtual void parse(std::string const& sourceCode) = 0;
-	virtual std::map<std::string, std::string> getOptions() const = 0;
-	virtual std::string getOption(std::string const& name) const = 0;
-	virtual bool hasOption(std::string const& name) const = 0;
-	virtual void setOption(std::string const& name, std::string const& value) = 0;
-	virtual void setOptions(std::map<std::string, std::string> const& options) = 0;
-	virtual std::string buildSource() const = 0;
-	virtual void buildDefaultEntry() = 0;
-	virtual std::list<std::string> getErrors() = 0;
+	// returns the options found in the tokenized source, throws ParserException if it doesn't match
+	virtual std::map<std::string, std::string> parse(ContentParser_Tokenizer const& tokenizer) const = 0;
+	// rebuilds the given source template using the given options
+	virtual std::string buildSource(std::map<std::string, std::string> const& options, std::string const& sourceTemplate) const = 0;
+	virtual std::string getDefaultSourceTemplate() const = 0;
+	virtual std::map<std::string, std::string> getDefaultOptions() const = 0;
+	virtual std::list<std::string> getErrors(std::map<std::string, std::string> const& options) const = 0;
+	// prepares the parser before first use (eg. compiles static patterns)
+	virtual void precompile() = 0;
 };
 
 #endif /* CONTENTPARSER_H_ */
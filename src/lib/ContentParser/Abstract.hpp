@@ -31,45 +31,14 @@ class ContentParser_Abstract :
 	public ContentParser,
 	public Trait_LoggerAware
 {
-	protected: std::map<std::string, std::string> options;
-
 	public:	virtual inline ~ContentParser_Abstract() {}
 
-	public:	std::map<std::string, std::string> getOptions() const
-	{
-		return this->options;
-	}
-
-	public:	bool hasOption(std::string const& name) const
-	{
-		return this->options.find(name) != this->options.end();
-	}
-
-	public:	std::string getOption(std::string const& name) const
-	{
-		if (!this->hasOption(name)) {
-			throw ItemNotFoundException("option '" + name + "' not found", __FILE__, __LINE__);
-		}
-
-		return this->options.at(name);
-	}
-
-	public:	void setOption(std::string const& name, std::string const& value)
-	{
-		this->options[name] = value;
-	}
-
-	public:	void setOptions(std::map<std::string, std::string> const& options)
-	{
-		this->options = options;
-	}
-
-	public:	std::list<std::string> getErrors()
+	public:	std::list<std::string> getErrors(std::map<std::string, std::string> const& options) const
 	{
 		std::list<std::string> errors;
 
 		// not empty
-		for (std::map<std::string, std::string>::iterator optionIter = this->options.begin(); optionIter != this->options.end(); optionIter++) {
+		for (std::map<std::string, std::string>::const_iterator optionIter = options.begin(); optionIter != options.end(); optionIter++) {
 			if (optionIter->first == "other_params") {
 				continue;
 			}
@@ -80,10 +49,10 @@ class ContentParser_Abstract :
 		}
 
 		// specific validators
-		if (this->options.find("iso_path_full") != this->options.end() && !this->_fileExists(this->options["iso_path_full"])) {
+		if (options.find("iso_path_full") != options.end() && !this->_fileExists(options.at("iso_path_full"))) {
 			errors.push_back("iso_path_full");
 		}
-		if (this->options.find("memtest_image_full") != this->options.end() && !this->_fileExists(this->options["memtest_image_full"])) {
+		if (options.find("memtest_image_full") != options.end() && !this->_fileExists(options.at("memtest_image_full"))) {
 			errors.push_back("memtest_image_full");
 		}
 
@@ -104,7 +73,7 @@ class ContentParser_Abstract :
 		return realPath;
 	}
 
-	protected: bool _fileExists(std::string const& fileName)
+	protected: bool _fileExists(std::string const& fileName) const
 	{
 		FILE* file = fopen(fileName.c_str(), "r");
 		if (file) {
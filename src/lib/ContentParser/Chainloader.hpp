@@ -28,37 +28,35 @@ class ContentParser_Chainloader :
 	public Regex_RegexConnection,
 	public Model_DeviceMap_Connection
 {
-	static const char* _regex;
-	std::string sourceCode;
 public:
-	void parse(std::string const& sourceCode) {
-		this->sourceCode = sourceCode;
-		try {
-			std::vector<std::string> result = this->regexEngine->match(ContentParser_Chainloader::_regex, this->sourceCode, '\\', '_');
-	
-			//check partition indices by uuid
-			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
-			if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
-				throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
-			}
-	
-			this->options["partition_uuid"] = result[3];
-		} catch (RegExNotMatchedException const& e) {
-			throw ParserException("parsing failed - RegEx not matched", __FILE__, __LINE__);
+	// used to rebuild the source - ContentParser_Tokenizer::matchChainloader returns the same groups
+	static const char* _regex;
+
+	std::map<std::string, std::string> parse(ContentParser_Tokenizer const& tokenizer) const {
+		std::vector<std::string> result = tokenizer.matchChainloader();
+
+		//check partition indices by uuid
+		Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
+		if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
+			throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
 		}
+
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = result[3];
+		return options;
 	}
 
-	std::string buildSource() const {
+	std::string buildSource(std::map<std::string, std::string> const& options, std::string const& sourceTemplate) const {
 		try {
-			Model_DeviceMap_PartitionIndex pIndex = deviceMap->getHarddriveIndexByPartitionUuid(this->options.at("partition_uuid"));
+			Model_DeviceMap_PartitionIndex pIndex = deviceMap->getHarddriveIndexByPartitionUuid(options.at("partition_uuid"));
 			std::map<int, std::string> newValues;
 			newValues[1] = pIndex.hddNum;
 			newValues[2] = pIndex.partNum;
-			newValues[3] = this->options.at("partition_uuid");
+			newValues[3] = options.at("partition_uuid");
 
 			std::string result;
 
-			result = this->regexEngine->replace(ContentParser_Chainloader::_regex, this->sourceCode, newValues, '\\', '_');
+			result = this->regexEngine->replace(ContentParser_Chainloader::_regex, sourceTemplate, newValues, '\\', '_');
 			this->regexEngine->match(ContentParser_Chainloader::_regex, result, '\\', '_');
 
 			return result;
@@ -67,7 +65,11 @@ public:
 		}
 	}
 
-	void buildDefaultEntry() {
+	void precompile() {
+		this->regexEngine->precompile(ContentParser_Chainloader::_regex);
+	}
+
+	std::string getDefaultSourceTemplate() const {
 		std::string defaultEntry =
 			"set root='(hd0,0)'\n"
 			"search --no-floppy --fs-uuid --set 000\n"
@@ -76,10 +78,13 @@ public:
 
 		assert(this->regexEngine->match(ContentParser_Chainloader::_regex, defaultEntry, '\\', '_').size() > 0);
 
-		this->sourceCode = defaultEntry;
+		return defaultEntry;
+	}
 
-		this->options.clear();
-		this->options["partition_uuid"] = "";
+	std::map<std::string, std::string> getDefaultOptions() const {
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = "";
+		return options;
 	}
 };
 
@@ -30,50 +30,55 @@ class ContentParser_FactoryImpl : public ContentParserFactory {
 
 	public: void registerParser(std::shared_ptr<ContentParser> parser, std::string const& name) {
 		assert(this->parsers.size() == this->names.size());
+		parser->precompile();
 		this->parsers.push_back(parser);
 		this->names.push_back(name);
 	}
 
-	public: std::shared_ptr<ContentParser> create(std::string const& sourceCode) {
+	public: ContentParser_Result parse(std::string const& sourceCode) const {
+		assert(this->parsers.size() == this->names.size());
+
+		ContentParser_Tokenizer tokenizer(sourceCode);
+		std::list<std::string>::const_iterator namesIter = this->names.begin();
 		for (auto parser : this->parsers) {
 			try {
-				parser->parse(sourceCode);
-				return parser;
+				return ContentParser_Result(*namesIter, parser->parse(tokenizer), sourceCode);
 			} catch (ParserException const& e) {
+				namesIter++;
 				continue;
 			}
 		}
 		throw ParserNotFoundException("no matching parser found", __FILE__, __LINE__);
 	}
 
-	public: std::shared_ptr<ContentParser> createByName(std::string const& name) {
-		assert(this->parsers.size() == this->names.size());
-	
-		std::list<std::string>::iterator namesIter = this->names.begin();
-		for (auto parser : this->parsers) {
-			if (name == *namesIter) {
-				return parser;
-			}
-			namesIter++;
-		}
-		throw ItemNotFoundException("no parser found by name '" + name + "'", __FILE__, __LINE__);
+	public: ContentParser_Result createDefault(std::string const& type) const {
+		std::shared_ptr<ContentParser> parser = this->getParserByName(type);
+		return ContentParser_Result(type, parser->getDefaultOptions(), parser->getDefaultSourceTemplate());
+	}
+
+	public: std::string buildSource(ContentParser_Result const& result) const {
+		return this->getParserByName(result.getType())->buildSource(result.getOptions(), result.getSourceTemplate());
+	}
+
+	public: std::list<std::string> getErrors(ContentParser_Result const& result) const {
+		return this->getParserByName(result.getType())->getErrors(result.getOptions());
 	}
 
 	public: std::list<std::string> const& getNames() const {
 		return this->names;
 	}
 
-	public: std::string getNameByInstance(ContentParser const& instance) const {
+	private: std::shared_ptr<ContentParser> getParserByName(std::string const& name) const {
 		assert(this->parsers.size() == this->names.size());
 	
 		std::list<std::string>::const_iterator namesIter = this->names.begin();
 		for (auto parser : this->parsers) {
-			if (&instance == &*parser) {
-				return *namesIter;
+			if (name == *namesIter) {
+				return parser;
 			}
 			namesIter++;
 		}
-		throw ItemNotFoundException("no parser found by instance pointer", __FILE__, __LINE__);
+		throw ItemNotFoundException("no parser found by name '" + name + "'", __FILE__, __LINE__);
 	}
 
 };
@@ -27,49 +27,47 @@ class ContentParser_Linux :
 	public Regex_RegexConnection,
 	public Model_DeviceMap_Connection
 {
-	static const char* _regex;
-	std::string sourceCode;
 public:
-	void parse(std::string const& sourceCode) {
-		this->sourceCode = sourceCode;
-		try {
-			std::vector<std::string> result = this->regexEngine->match(ContentParser_Linux::_regex, sourceCode, '\\', '_');
-	
-			//check partition indices by uuid
-			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[6]);
-			if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
-				throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
-			}
-	
-			//check if the uuids (Kernel <-> search command) are the same
-			if (result[3] != result[6])
-				throw ParserException("parsing failed - uuid different", __FILE__, __LINE__);
-	
-			//assign data
-			this->options["partition_uuid"] = result[6];
-			this->options["linux_image"] = this->unescape(result[5]);
-			this->options["other_params"] = Helper::ltrim(result[7], " ");
-			this->options["initramfs"] = this->unescape(result[9]);
-		} catch (RegExNotMatchedException const& e) {
-			throw ParserException("parsing failed - RegEx not matched", __FILE__, __LINE__);
+	// used to rebuild the source - ContentParser_Tokenizer::matchLinux returns the same groups
+	static const char* _regex;
+
+	std::map<std::string, std::string> parse(ContentParser_Tokenizer const& tokenizer) const {
+		std::vector<std::string> result = tokenizer.matchLinux();
+
+		//check partition indices by uuid
+		Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[6]);
+		if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
+			throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
 		}
+
+		//check if the uuids (Kernel <-> search command) are the same
+		if (result[3] != result[6])
+			throw ParserException("parsing failed - uuid different", __FILE__, __LINE__);
+
+		//assign data
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = result[6];
+		options["linux_image"] = this->unescape(result[5]);
+		options["other_params"] = Helper::ltrim(result[7], " ");
+		options["initramfs"] = this->unescape(result[9]);
+		return options;
 	}
 
-	std::string buildSource() const {
+	std::string buildSource(std::map<std::string, std::string> const& options, std::string const& sourceTemplate) const {
 		try {
-			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(this->options.at("partition_uuid"));
+			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(options.at("partition_uuid"));
 			std::map<int, std::string> newValues;
 			newValues[1] = pIndex.hddNum;
 			newValues[2] = pIndex.partNum;
-			newValues[3] = this->options.at("partition_uuid");
-			newValues[5] = this->escape(this->options.at("linux_image"));
-			newValues[6] = this->options.at("partition_uuid");
-			newValues[7] = this->options.at("other_params").size() ? " " + this->options.at("other_params") : "";
-			newValues[9] = this->escape(this->options.at("initramfs"));
+			newValues[3] = options.at("partition_uuid");
+			newValues[5] = this->escape(options.at("linux_image"));
+			newValues[6] = options.at("partition_uuid");
+			newValues[7] = options.at("other_params").size() ? " " + options.at("other_params") : "";
+			newValues[9] = this->escape(options.at("initramfs"));
 
 			std::string result;
 
-			result = this->regexEngine->replace(ContentParser_Linux::_regex, this->sourceCode, newValues, '\\', '_');
+			result = this->regexEngine->replace(ContentParser_Linux::_regex, sourceTemplate, newValues, '\\', '_');
 			this->regexEngine->match(ContentParser_Linux::_regex, result, '\\', '_');
 
 			return result;
@@ -78,7 +76,11 @@ public:
 		}
 	}
 
-	void buildDefaultEntry() {
+	void precompile() {
+		this->regexEngine->precompile(ContentParser_Linux::_regex);
+	}
+
+	std::string getDefaultSourceTemplate() const {
 		std::string defaultEntry =
 			"set root='(hd0,0)'\n"
 			"search --no-floppy --fs-uuid --set=root 000\n"
@@ -87,13 +89,16 @@ public:
 
 		assert(this->regexEngine->match(ContentParser_Linux::_regex, defaultEntry, '\\', '_').size() > 0);
 
-		this->sourceCode = defaultEntry;
+		return defaultEntry;
+	}
 
-		this->options.clear();
-		this->options["partition_uuid"] = "";
-		this->options["linux_image"] = "/vmlinuz";
-		this->options["initramfs"] = "/initrd.img";
-		this->options["other_params"] = "";
+	std::map<std::string, std::string> getDefaultOptions() const {
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = "";
+		options["linux_image"] = "/vmlinuz";
+		options["initramfs"] = "/initrd.img";
+		options["other_params"] = "";
+		return options;
 	}
 
 };
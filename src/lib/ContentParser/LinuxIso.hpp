@@ -30,62 +30,59 @@ class ContentParser_LinuxIso :
 	public Model_MountTable_Connection,
 	public Model_DeviceDataList_Connection
 {
-	static const char* _regex;
-	std::string sourceCode;
 public:
-	void parse(std::string const& sourceCode) {
-		this->sourceCode = sourceCode;
-		try {
-			std::vector<std::string> result = this->regexEngine->match(ContentParser_LinuxIso::_regex, this->sourceCode, '\\', '_');
-	
-			//check partition indices by uuid
-			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
-			if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
-				throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
-			}
-	
-			//check if the iso filepaths are the same
-			if (this->unescape(result[4]) != this->unescape(result[6]))
-				throw ParserException("parsing failed - iso filepaths are different", __FILE__, __LINE__);
-
-			//assign data
-			this->options["partition_uuid"] = result[3];
-			this->options["linux_image"] = Helper::str_replace("(loop)", "", this->unescape(result[5]));
-			this->options["initramfs"] = Helper::str_replace("(loop)", "", this->unescape(result[8]));
-			this->options["iso_path"] = this->unescape(result[4]);
-			this->options["iso_path_full"] = "";
-			this->options["other_params"] = Helper::ltrim(result[7], " ");
-
-			try {
-				std::string device = this->deviceDataList->getDeviceByUuid(this->options["partition_uuid"]);
-				this->options["iso_path_full"] = Helper::rtrim(this->mountTable->findByDevice(device).mountpoint, "/") + "/" + Helper::ltrim(this->options["iso_path"], "/");
-				if (!this->_fileExists(this->options["iso_path_full"])) {
-					throw ItemNotFoundException("iso file '" + this->options["iso_path_full"] + "'not found!", __FILE__, __LINE__);
-				}
-				this->options.erase("partition_uuid");
-				this->options.erase("iso_path");
-			} catch (ItemNotFoundException const& e) {
-				// partition not mounted or file not found
-				this->options.erase("iso_path_full");
-			}
+	// used to rebuild the source - ContentParser_Tokenizer::matchLinuxIso returns the same groups
+	static const char* _regex;
 
+	std::map<std::string, std::string> parse(ContentParser_Tokenizer const& tokenizer) const {
+		std::vector<std::string> result = tokenizer.matchLinuxIso();
 
-		} catch (RegExNotMatchedException const& e) {
-			throw ParserException("parsing failed - RegEx not matched", __FILE__, __LINE__);
+		//check partition indices by uuid
+		Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
+		if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
+			throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
+		}
+
+		//check if the iso filepaths are the same
+		if (this->unescape(result[4]) != this->unescape(result[6]))
+			throw ParserException("parsing failed - iso filepaths are different", __FILE__, __LINE__);
+
+		//assign data
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = result[3];
+		options["linux_image"] = Helper::str_replace("(loop)", "", this->unescape(result[5]));
+		options["initramfs"] = Helper::str_replace("(loop)", "", this->unescape(result[8]));
+		options["iso_path"] = this->unescape(result[4]);
+		options["iso_path_full"] = "";
+		options["other_params"] = Helper::ltrim(result[7], " ");
+
+		try {
+			std::string device = this->deviceDataList->getDeviceByUuid(options["partition_uuid"]);
+			options["iso_path_full"] = Helper::rtrim(this->mountTable->findByDevice(device).mountpoint, "/") + "/" + Helper::ltrim(options["iso_path"], "/");
+			if (!this->_fileExists(options["iso_path_full"])) {
+				throw ItemNotFoundException("iso file '" + options["iso_path_full"] + "'not found!", __FILE__, __LINE__);
+			}
+			options.erase("partition_uuid");
+			options.erase("iso_path");
+		} catch (ItemNotFoundException const& e) {
+			// partition not mounted or file not found
+			options.erase("iso_path_full");
 		}
+
+		return options;
 	}
 
-	std::string buildSource() const {
+	std::string buildSource(std::map<std::string, std::string> const& options, std::string const& sourceTemplate) const {
 		std::string partitionUuid, isoPath;
 
-		if (this->options.find("iso_path_full") != this->options.end()) {
-			std::string realIsoPath = this->_realpath(this->options.at("iso_path_full"));
+		if (options.find("iso_path_full") != options.end()) {
+			std::string realIsoPath = this->_realpath(options.at("iso_path_full"));
 			Model_MountTable_Mountpoint& mountpoint = this->mountTable->getByFilePath(realIsoPath);
-			partitionUuid = (*this->deviceDataList)[mountpoint.device]["UUID"];
+			partitionUuid = this->getPartitionUuid(mountpoint.device);
 			isoPath = realIsoPath.substr(mountpoint.mountpoint.size());
 		} else {
-			partitionUuid = this->options.at("partition_uuid");
-			isoPath = this->options.at("iso_path");
+			partitionUuid = options.at("partition_uuid");
+			isoPath = options.at("iso_path");
 		}
 
 		try {
@@ -95,14 +92,14 @@ public:
 			newValues[2] = pIndex.partNum;
 			newValues[3] = partitionUuid;
 			newValues[4] = this->escape(isoPath);
-			newValues[5] = this->escape("(loop)" + this->options.at("linux_image"));
+			newValues[5] = this->escape("(loop)" + options.at("linux_image"));
 			newValues[6] = this->escape(isoPath);
-			newValues[7] = this->options.at("other_params").size() ? " " + this->options.at("other_params") : "";
-			newValues[8] = this->escape("(loop)" + this->options.at("initramfs"));
+			newValues[7] = options.at("other_params").size() ? " " + options.at("other_params") : "";
+			newValues[8] = this->escape("(loop)" + options.at("initramfs"));
 
 			std::string result;
 
-			result = this->regexEngine->replace(ContentParser_LinuxIso::_regex, this->sourceCode, newValues, '\\', '_');
+			result = this->regexEngine->replace(ContentParser_LinuxIso::_regex, sourceTemplate, newValues, '\\', '_');
 			this->regexEngine->match(ContentParser_LinuxIso::_regex, result, '\\', '_');
 
 			return result;
@@ -112,7 +109,11 @@ public:
 	}
 
 
-	void buildDefaultEntry() {
+	void precompile() {
+		this->regexEngine->precompile(ContentParser_LinuxIso::_regex);
+	}
+
+	std::string getDefaultSourceTemplate() const {
 		std::string defaultEntry =
 			"set root='(hd0,0)'\n"
 			"search --no-floppy --fs-uuid --set=root 000000000000000000\n"
@@ -122,13 +123,25 @@ public:
 
 		assert(this->regexEngine->match(ContentParser_LinuxIso::_regex, defaultEntry, '\\', '_').size() > 0);
 
-		this->sourceCode = defaultEntry;
+		return defaultEntry;
+	}
 
-		this->options.clear();
-		this->options["linux_image"] = "/casper/vmlinuz";
-		this->options["initramfs"] = "/casper/initrd.lz";
-		this->options["iso_path_full"] = "";
-		this->options["other_params"] = "quiet splash locale=en_US bootkbd=us console-setup/layoutcode=us noeject --";
+	std::map<std::string, std::string> getDefaultOptions() const {
+		std::map<std::string, std::string> options;
+		options["linux_image"] = "/casper/vmlinuz";
+		options["initramfs"] = "/casper/initrd.lz";
+		options["iso_path_full"] = "";
+		options["other_params"] = "quiet splash locale=en_US bootkbd=us console-setup/layoutcode=us noeject --";
+		return options;
+	}
+
+	// read only lookup - the device list is shared with other parser calls
+	private: std::string getPartitionUuid(std::string const& device) const {
+		auto deviceIter = this->deviceDataList->find(device);
+		if (deviceIter == this->deviceDataList->end() || deviceIter->second.find("UUID") == deviceIter->second.end()) {
+			return "";
+		}
+		return deviceIter->second.at("UUID");
 	}
 
 };
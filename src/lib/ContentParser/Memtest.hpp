@@ -30,54 +30,52 @@ class ContentParser_Memtest :
 	public Model_MountTable_Connection,
 	public Model_DeviceDataList_Connection
 {
-	static const char* _regex;
-	std::string sourceCode;
 public:
-	void parse(std::string const& sourceCode) {
-		this->sourceCode = sourceCode;
+	// used to rebuild the source - ContentParser_Tokenizer::matchMemtest returns the same groups
+	static const char* _regex;
+
+	std::map<std::string, std::string> parse(ContentParser_Tokenizer const& tokenizer) const {
+		std::vector<std::string> result = tokenizer.matchMemtest();
+
+
+		//check partition indices by uuid
+		Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
+		if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
+			throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
+		}
+
+		std::map<std::string, std::string> options;
+		options["partition_uuid"] = result[3];
+		options["memtest_image"] = this->unescape(result[4]);
+
+
 		try {
-			std::vector<std::string> result = this->regexEngine->match(ContentParser_Memtest::_regex, this->sourceCode, '\\', '_');
-	
-	
-			//check partition indices by uuid
-			Model_DeviceMap_PartitionIndex pIndex = this->deviceMap->getHarddriveIndexByPartitionUuid(result[3]);
-			if (pIndex.hddNum != result[1] || pIndex.partNum != result[2]){
-				throw ParserException("parsing failed - hdd num check", __FILE__, __LINE__);
+			std::string device = this->deviceDataList->getDeviceByUuid(options["partition_uuid"]);
+			options["memtest_image_full"] = Helper::rtrim(this->mountTable->findByDevice(device).mountpoint, "/") + "/" + Helper::ltrim(options["memtest_image"], "/");
+			if (!this->_fileExists(options["memtest_image_full"])) {
+				throw ItemNotFoundException("memtest image '" + options["memtest_image_full"] + "'not found!", __FILE__, __LINE__);
 			}
-	
-			this->options["partition_uuid"] = result[3];
-			this->options["memtest_image"] = this->unescape(result[4]);
-
-
-			try {
-				std::string device = this->deviceDataList->getDeviceByUuid(this->options["partition_uuid"]);
-				this->options["memtest_image_full"] = Helper::rtrim(this->mountTable->findByDevice(device).mountpoint, "/") + "/" + Helper::ltrim(this->options["memtest_image"], "/");
-				if (!this->_fileExists(this->options["memtest_image_full"])) {
-					throw ItemNotFoundException("memtest image '" + this->options["memtest_image_full"] + "'not found!", __FILE__, __LINE__);
-				}
-				this->options.erase("partition_uuid");
-				this->options.erase("memtest_image");
-			} catch (ItemNotFoundException const& e) {
-				// partition not mounted
-				this->options.erase("memtest_image_full");
-			}
-
-		} catch (RegExNotMatchedException const& e) {
-			throw ParserException("parsing failed - RegEx not matched", __FILE__, __LINE__);
+			options.erase("partition_uuid");
+			options.erase("memtest_image");
+		} catch (ItemNotFoundException const& e) {
+			// partition not mounted
+			options.erase("memtest_image_full");
 		}
+
+		return options;
 	}
 
-	std::string buildSource() const {
+	std::string buildSource(std::map<std::string, std::string> const& options, std::string const& sourceTemplate) const {
 		std::string partitionUuid, filePath;
 
-		if (this->options.find("memtest_image_full") != this->options.end()) {
-			std::string realMemtestPath = this->_realpath(this->options.at("memtest_image_full"));
+		if (options.find("memtest_image_full") != options.end()) {
+			std::string realMemtestPath = this->_realpath(options.at("memtest_image_full"));
 			Model_MountTable_Mountpoint& mountpoint = this->mountTable->getByFilePath(realMemtestPath);
-			partitionUuid = (*this->deviceDataList)[mountpoint.device]["UUID"];
+			partitionUuid = this->getPartitionUuid(mountpoint.device);
 			filePath = realMemtestPath.substr(mountpoint.mountpoint.size());
 		} else {
-			partitionUuid = this->options.at("partition_uuid");
-			filePath = this->options.at("memtest_image");
+			partitionUuid = options.at("partition_uuid");
+			filePath = options.at("memtest_image");
 		}
 
 		try {
@@ -90,7 +88,7 @@ public:
 
 			std::string result;
 
-			result = this->regexEngine->replace(ContentParser_Memtest::_regex, this->sourceCode, newValues, '\\', '_');
+			result = this->regexEngine->replace(ContentParser_Memtest::_regex, sourceTemplate, newValues, '\\', '_');
 			this->regexEngine->match(ContentParser_Memtest::_regex, result, '\\', '_');
 
 			return result;
@@ -100,20 +98,35 @@ public:
 	}
 
 
-	void buildDefaultEntry() {
+	void precompile() {
+		this->regexEngine->precompile(ContentParser_Memtest::_regex);
+	}
+
+	std::string getDefaultSourceTemplate() const {
 		std::string defaultEntry =
 			"set root='(hd0,0)'\n"
 			"search --no-floppy --fs-uuid --set 000\n"
 			"linux16 ___";
 
-		this->sourceCode = defaultEntry;
-
 		assert(this->regexEngine->match(ContentParser_Memtest::_regex, defaultEntry, '\\', '_').size() > 0);
 
-		this->options.clear();
-		this->options["memtest_image_full"] = "/boot/memtest86+.bin";
+		return defaultEntry;
+	}
+
+	std::map<std::string, std::string> getDefaultOptions() const {
+		std::map<std::string, std::string> options;
+		options["memtest_image_full"] = "/boot/memtest86+.bin";
+		return options;
 	}
 
+	// read only lookup - the device list is shared with other parser calls
+	private: std::string getPartitionUuid(std::string const& device) const {
+		auto deviceIter = this->deviceDataList->find(device);
+		if (deviceIter == this->deviceDataList->end() || deviceIter->second.find("UUID") == deviceIter->second.end()) {
+			return "";
+		}
+		return deviceIter->second.at("UUID");
+	}
 };
 
 const char* ContentParser_Memtest::_regex =
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef CONTENT_PARSER_RESULT_H_
+#define CONTENT_PARSER_RESULT_H_
+#include <map>
+#include <string>
+#include "../Exception.hpp"
+
+/**
+ * immutable result of a content parser run: the type (name of the matching parser),
+ * the extracted options and the source which is used as template when rebuilding the entry
+ */
+class ContentParser_Result
+{
+	private: std::string type;
+	private: std::map<std::string, std::string> options;
+	private: std::string sourceTemplate;
+
+	public: ContentParser_Result(
+		std::string const& type,
+		std::map<std::string, std::string> const& options,
+		std::string const& sourceTemplate
+	) :
+		type(type),
+		options(options),
+		sourceTemplate(sourceTemplate)
+	{}
+
+	public: std::string const& getType() const
+	{
+		return this->type;
+	}
+
+	public: std::map<std::string, std::string> const& getOptions() const
+	{
+		return this->options;
+	}
+
+	public: bool hasOption(std::string const& name) const
+	{
+		return this->options.find(name) != this->options.end();
+	}
+
+	public: std::string const& getOption(std::string const& name) const
+	{
+		if (!this->hasOption(name)) {
+			throw ItemNotFoundException("option '" + name + "' not found", __FILE__, __LINE__);
+		}
+
+		return this->options.at(name);
+	}
+
+	public: std::string const& getSourceTemplate() const
+	{
+		return this->sourceTemplate;
+	}
+
+	// copy of this result using other options - type and template are kept
+	public: ContentParser_Result withOptions(std::map<std::string, std::string> const& options) const
+	{
+		return ContentParser_Result(this->type, options, this->sourceTemplate);
+	}
+};
+
+#endif /* CONTENT_PARSER_RESULT_H_ */
@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef CONTENT_PARSER_TOKENIZER_H_
+#define CONTENT_PARSER_TOKENIZER_H_
+#include <string>
+#include <vector>
+#include <cctype>
+#include "../Exception.hpp"
+
+/**
+ * Splits a menuentry body into lines once and recognizes the line structures
+ * of the content parsers (set root, search --fs-uuid, loopback, linux/linux16,
+ * initrd, chainloader and echo lines) without trying their patterns one after
+ * another.
+ *
+ * The match* methods return the same capture groups as matching the parser's
+ * pattern (ContentParser_*::_regex) using Regex::match(pattern, source, '\\', '_').
+ * Group 0 is the matched text. Values spanning multiple lines (except where a
+ * value is the last part of the pattern) aren't recognized.
+ */
+class ContentParser_Tokenizer
+{
+	private: struct Line
+	{
+		size_t start;
+		size_t end; // position of the line break (or the end of the source)
+	};
+
+	private: std::string sourceCode;
+	// source code with escape sequences masked - quotes inside of escape sequences are no quotes
+	private: std::string masked;
+	private: std::vector<Line> lines;
+
+	public: ContentParser_Tokenizer(std::string const& sourceCode) :
+		sourceCode(sourceCode),
+		masked(sourceCode)
+	{
+		for (size_t pos = 0; pos < this->masked.size(); pos++) {
+			if (this->masked[pos] == '\\') {
+				this->masked[pos] = '_';
+				if (pos + 1 < this->masked.size()) {
+					this->masked[++pos] = '_';
+				}
+			}
+		}
+
+		size_t lineStart = 0;
+		for (size_t pos = 0; pos <= this->masked.size(); pos++) {
+			if (pos == this->masked.size() || this->masked[pos] == '\n') {
+				Line line = {lineStart, pos};
+				this->lines.push_back(line);
+				lineStart = pos + 1;
+			}
+		}
+	}
+
+	public: std::string const& getSourceCode() const
+	{
+		return this->sourceCode;
+	}
+
+	/**
+	 * set root, search, optional echo, linux (root=UUID= as first parameter),
+	 * optional echo, initrd as last non-blank line
+	 */
+	public: std::vector<std::string> matchLinux() const
+	{
+		std::vector<std::string> result(10);
+		for (size_t lineNum = 0; lineNum + 3 < this->lines.size(); lineNum++) {
+			size_t matchStart = 0;
+			if (!this->matchSetRoot(lineNum, false, result, matchStart) || !this->matchSearch(lineNum + 1, false, result)) {
+				continue;
+			}
+			size_t current = lineNum + 2;
+			result[4] = "";
+			if (this->matchEcho(current)) {
+				result[4] = this->captureLine(current);
+				current++;
+			}
+			if (current >= this->lines.size() || !this->matchLinuxLine(current, result)) {
+				continue;
+			}
+			current++;
+			result[8] = "";
+			if (current < this->lines.size() && this->matchEcho(current)) {
+				result[8] = this->captureLine(current);
+				current++;
+			}
+			if (current >= this->lines.size() || !this->matchFinalInitrd(current, result)) {
+				continue;
+			}
+			result[0] = this->capture(matchStart, this->masked.size());
+			return result;
+		}
+		throw ParserException("parsing failed - no linux entry", __FILE__, __LINE__);
+	}
+
+	/**
+	 * set root, search, loopback, linux (loop) with iso-scan/filename, initrd (loop)
+	 */
+	public: std::vector<std::string> matchLinuxIso() const
+	{
+		std::vector<std::string> result(9);
+		for (size_t lineNum = 0; lineNum + 4 < this->lines.size(); lineNum++) {
+			size_t matchStart = 0;
+			if (!this->matchSetRoot(lineNum, false, result, matchStart)
+				|| !this->matchSearch(lineNum + 1, false, result)
+				|| !this->matchLoopback(lineNum + 2, result)
+				|| !this->matchIsoLinuxLine(lineNum + 3, result)
+			) {
+				continue;
+			}
+			size_t matchEnd = 0;
+			if (!this->matchIsoInitrd(lineNum + 4, result, matchEnd)) {
+				continue;
+			}
+			result[0] = this->capture(matchStart, matchEnd);
+			return result;
+		}
+		throw ParserException("parsing failed - no linux iso entry", __FILE__, __LINE__);
+	}
+
+	/**
+	 * set root, search, anything, chainloader +1
+	 */
+	public: std::vector<std::string> matchChainloader() const
+	{
+		std::vector<std::string> result(4);
+		for (size_t lineNum = 0; lineNum + 2 < this->lines.size(); lineNum++) {
+			size_t matchStart = 0;
+			if (!this->matchSetRoot(lineNum, true, result, matchStart) || !this->matchSearch(lineNum + 1, true, result)) {
+				continue;
+			}
+			// the pattern is greedy, so the last chainloader call is used
+			size_t bodyStart = this->lines[lineNum + 2].start;
+			size_t matchEnd = std::string::npos;
+			for (size_t pos = this->masked.find("chainloader", bodyStart); pos != std::string::npos; pos = this->masked.find("chainloader", pos + 1)) {
+				size_t paramPos = this->skipBlanks(pos + 11, this->masked.size());
+				if (paramPos > pos + 11 && this->startsWith(paramPos, this->masked.size(), "+1")) {
+					matchEnd = paramPos + 2;
+				}
+			}
+			if (matchEnd == std::string::npos) {
+				continue;
+			}
+			if (matchEnd < this->masked.size() && this->masked[matchEnd] == '\n') {
+				matchEnd++;
+			}
+			matchEnd = this->skipBlanks(matchEnd, this->masked.size());
+			result[0] = this->capture(matchStart, matchEnd);
+			return result;
+		}
+		throw ParserException("parsing failed - no chainloader entry", __FILE__, __LINE__);
+	}
+
+	/**
+	 * set root, search, linux16 as last line
+	 */
+	public: std::vector<std::string> matchMemtest() const
+	{
+		std::vector<std::string> result(5);
+		for (size_t lineNum = 0; lineNum + 2 < this->lines.size(); lineNum++) {
+			size_t matchStart = 0;
+			if (!this->matchSetRoot(lineNum, false, result, matchStart) || !this->matchSearch(lineNum + 1, false, result)) {
+				continue;
+			}
+			size_t matchEnd = 0;
+			if (!this->matchMemtestLine(lineNum + 2, result, matchEnd)) {
+				continue;
+			}
+			result[0] = this->capture(matchStart, matchEnd);
+			return result;
+		}
+		throw ParserException("parsing failed - no memtest entry", __FILE__, __LINE__);
+	}
+
+	// [ \t]*set root='\(hd([0-9]+)[^0-9]+([0-9]+)\)'\n - may start anywhere in the line, multipleBlanks: set[ \t]+root
+	private: bool matchSetRoot(size_t lineNum, bool multipleBlanks, std::vector<std::string>& result, size_t& matchStart) const
+	{
+		Line const& line = this->lines[lineNum];
+		if (line.end == this->masked.size()) {
+			return false;
+		}
+		for (size_t setPos = this->masked.find("set", line.start); setPos != std::string::npos && setPos < line.end; setPos = this->masked.find("set", setPos + 1)) {
+			size_t pos = setPos + 3;
+			size_t rootPos = this->skipBlanks(pos, line.end);
+			if (rootPos == pos || (!multipleBlanks && (rootPos != pos + 1 || this->masked[pos] != ' ')) || !this->startsWith(rootPos, line.end, "root='(hd")) {
+				continue;
+			}
+			size_t hddStart = rootPos + 9;
+			size_t hddEnd = this->skipDigits(hddStart, line.end, true);
+			size_t partStart = this->skipDigits(hddEnd, line.end, false);
+			size_t partEnd = this->skipDigits(partStart, line.end, true);
+			if (hddEnd == hddStart || partStart == hddEnd || partEnd == partStart || partEnd + 2 != line.end || !this->startsWith(partEnd, line.end, ")'")) {
+				continue;
+			}
+			result[1] = this->capture(hddStart, hddEnd);
+			result[2] = this->capture(partStart, partEnd);
+			matchStart = setPos;
+			while (matchStart > line.start && this->isBlank(this->masked[matchStart - 1])) {
+				matchStart--;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// [ \t]*search[ \t]+--no-floppy[ \t]+--fs-uuid[ \t]+--set(?:=root)? ([-0-9a-fA-F]+)\n, multipleBlanks: --set(?:=root)?[ \t]+
+	private: bool matchSearch(size_t lineNum, bool multipleBlanks, std::vector<std::string>& result) const
+	{
+		Line const& line = this->lines[lineNum];
+		if (line.end == this->masked.size()) {
+			return false;
+		}
+		size_t pos = this->skipBlanks(line.start, line.end);
+		char const* words[] = {"search", "--no-floppy", "--fs-uuid"};
+		for (char const* word : words) {
+			if (!this->startsWith(pos, line.end, word)) {
+				return false;
+			}
+			size_t wordEnd = pos + std::string(word).size();
+			pos = this->skipBlanks(wordEnd, line.end);
+			if (pos == wordEnd) {
+				return false;
+			}
+		}
+		if (!this->startsWith(pos, line.end, "--set")) {
+			return false;
+		}
+		pos += 5;
+		if (this->startsWith(pos, line.end, "=root")) {
+			pos += 5;
+		}
+		size_t uuidStart = this->skipBlanks(pos, line.end);
+		if (uuidStart == pos || (!multipleBlanks && (uuidStart != pos + 1 || this->masked[pos] != ' '))) {
+			return false;
+		}
+		size_t uuidEnd = this->skipUuid(uuidStart, line.end);
+		if (uuidEnd == uuidStart || uuidEnd != line.end) {
+			return false;
+		}
+		result[3] = this->capture(uuidStart, uuidEnd);
+		return true;
+	}
+
+	// [ \t]*echo[ \t]+.*\n
+	private: bool matchEcho(size_t lineNum) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t pos = this->skipBlanks(line.start, line.end);
+		return line.end != this->masked.size()
+			&& this->startsWith(pos, line.end, "echo")
+			&& this->skipBlanks(pos + 4, line.end) > pos + 4;
+	}
+
+	// [ \t]*linux[ \t]+("[^"]*"|[^ \t]+)[ \t]+root=UUID=([-0-9a-fA-F]+)(.*)\n
+	private: bool matchLinuxLine(size_t lineNum, std::vector<std::string>& result) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t imageStart = 0;
+		if (line.end == this->masked.size() || !this->matchCommand(line, "linux", imageStart)) {
+			return false;
+		}
+		size_t rootParamPos = std::string::npos, imageEnd = 0;
+		if (this->masked[imageStart] == '"') {
+			size_t quoteEnd = this->masked.find('"', imageStart + 1);
+			if (quoteEnd < line.end) {
+				imageEnd = quoteEnd + 1;
+				rootParamPos = this->skipBlanks(imageEnd, line.end);
+				if (rootParamPos == imageEnd || !this->startsWith(rootParamPos, line.end, "root=UUID=")) {
+					rootParamPos = std::string::npos;
+				}
+			}
+		}
+		if (rootParamPos == std::string::npos) {
+			imageEnd = this->skipNonBlanks(imageStart, line.end);
+			rootParamPos = this->skipBlanks(imageEnd, line.end);
+			if (imageEnd == imageStart || rootParamPos == imageEnd || !this->startsWith(rootParamPos, line.end, "root=UUID=")) {
+				return false;
+			}
+		}
+		size_t uuidStart = rootParamPos + 10;
+		size_t uuidEnd = this->skipUuid(uuidStart, line.end);
+		if (uuidEnd == uuidStart) {
+			return false;
+		}
+		result[5] = this->capture(imageStart, imageEnd);
+		result[6] = this->capture(uuidStart, uuidEnd);
+		result[7] = this->capture(uuidEnd, line.end);
+		return true;
+	}
+
+	// [ \t]*initrd[ \t]+("[^"]*"|[^ \n]+)[ \n\t]*$
+	private: bool matchFinalInitrd(size_t lineNum, std::vector<std::string>& result) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t fileStart = 0;
+		if (!this->matchCommand(line, "initrd", fileStart)) {
+			return false;
+		}
+		if (this->masked[fileStart] == '"') {
+			size_t quoteEnd = this->masked.find('"', fileStart + 1);
+			if (quoteEnd != std::string::npos && this->isWhitespaceOnly(quoteEnd + 1)) {
+				result[9] = this->capture(fileStart, quoteEnd + 1);
+				return true;
+			}
+		}
+		size_t fileEnd = this->masked.find_first_of(" \n", fileStart);
+		if (fileEnd == std::string::npos) {
+			fileEnd = this->masked.size();
+		}
+		if (fileEnd == fileStart || !this->isWhitespaceOnly(fileEnd)) {
+			return false;
+		}
+		result[9] = this->capture(fileStart, fileEnd);
+		return true;
+	}
+
+	// [ \t]*loopback[ \t]+loop[ \t]+("[^"]*"|[^ \t]+)\n
+	private: bool matchLoopback(size_t lineNum, std::vector<std::string>& result) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t loopStart = 0;
+		if (line.end == this->masked.size() || !this->matchCommand(line, "loopback", loopStart) || !this->startsWith(loopStart, line.end, "loop")) {
+			return false;
+		}
+		size_t fileStart = this->skipBlanks(loopStart + 4, line.end);
+		if (fileStart == loopStart + 4 || fileStart == line.end) {
+			return false;
+		}
+		bool isQuoted = this->masked[fileStart] == '"' && this->masked.find('"', fileStart + 1) == line.end - 1;
+		if (!isQuoted && this->skipNonBlanks(fileStart, line.end) != line.end) {
+			return false;
+		}
+		result[4] = this->capture(fileStart, line.end);
+		return true;
+	}
+
+	// [ \t]*linux[ \t]+("\(loop\)[^"]*"|\(loop\)[^ \t]*)[ \t]+boot=casper iso-scan/filename=("[^"]*"|[^ \t]+)(.*)\n
+	private: bool matchIsoLinuxLine(size_t lineNum, std::vector<std::string>& result) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t imageStart = 0;
+		if (line.end == this->masked.size() || !this->matchCommand(line, "linux", imageStart)) {
+			return false;
+		}
+		size_t imageEnd = this->skipLoopFile(imageStart, line.end);
+		if (imageEnd == std::string::npos) {
+			return false;
+		}
+		size_t paramPos = this->skipBlanks(imageEnd, line.end);
+		if (paramPos == imageEnd || !this->startsWith(paramPos, line.end, "boot=casper iso-scan/filename=")) {
+			return false;
+		}
+		size_t isoStart = paramPos + 30;
+		size_t isoEnd = std::string::npos;
+		if (isoStart < line.end && this->masked[isoStart] == '"') {
+			size_t quoteEnd = this->masked.find('"', isoStart + 1);
+			if (quoteEnd < line.end) {
+				isoEnd = quoteEnd + 1;
+			}
+		}
+		if (isoEnd == std::string::npos) {
+			isoEnd = this->skipNonBlanks(isoStart, line.end);
+			if (isoEnd == isoStart) {
+				return false;
+			}
+		}
+		result[5] = this->capture(imageStart, imageEnd);
+		result[6] = this->capture(isoStart, isoEnd);
+		result[7] = this->capture(isoEnd, line.end);
+		return true;
+	}
+
+	// [ \t]*initrd[ \t]+("\(loop\)[^"]*"|\(loop\)[^ \t]*) - nothing expected afterwards
+	private: bool matchIsoInitrd(size_t lineNum, std::vector<std::string>& result, size_t& matchEnd) const
+	{
+		size_t fileStart = 0;
+		if (!this->matchCommand(this->lines[lineNum], "initrd", fileStart)) {
+			return false;
+		}
+		// the file name isn't limited to the line
+		matchEnd = this->skipLoopFile(fileStart, this->masked.size());
+		if (matchEnd == std::string::npos) {
+			return false;
+		}
+		result[8] = this->capture(fileStart, matchEnd);
+		return true;
+	}
+
+	// [ \t]*linux16[ \t]*("[^"]*"|[^ \t\n]+).*$
+	private: bool matchMemtestLine(size_t lineNum, std::vector<std::string>& result, size_t& matchEnd) const
+	{
+		Line const& line = this->lines[lineNum];
+		size_t commandPos = this->skipBlanks(line.start, line.end);
+		if (!this->startsWith(commandPos, line.end, "linux16")) {
+			return false;
+		}
+		size_t fileStart = this->skipBlanks(commandPos + 7, line.end);
+		if (fileStart == line.end) {
+			return false;
+		}
+		if (this->masked[fileStart] == '"') {
+			size_t quoteEnd = this->masked.find('"', fileStart + 1);
+			if (quoteEnd != std::string::npos) {
+				size_t lineEnd = this->masked.find('\n', quoteEnd);
+				if (lineEnd == std::string::npos || lineEnd + 1 == this->masked.size()) {
+					result[4] = this->capture(fileStart, quoteEnd + 1);
+					matchEnd = lineEnd == std::string::npos ? this->masked.size() : lineEnd;
+					return true;
+				}
+			}
+		}
+		size_t fileEnd = this->skipNonBlanks(fileStart, line.end);
+		if (fileEnd == fileStart || (line.end != this->masked.size() && line.end + 1 != this->masked.size())) {
+			return false;
+		}
+		result[4] = this->capture(fileStart, fileEnd);
+		matchEnd = line.end;
+		return true;
+	}
+
+	// [ \t]*command[ \t]+ - returns the position of the first parameter
+	private: bool matchCommand(Line const& line, std::string const& command, size_t& paramPos) const
+	{
+		size_t pos = this->skipBlanks(line.start, line.end);
+		if (!this->startsWith(pos, line.end, command)) {
+			return false;
+		}
+		paramPos = this->skipBlanks(pos + command.size(), line.end);
+		return paramPos > pos + command.size() && paramPos < line.end;
+	}
+
+	// "\(loop\)[^"]*"|\(loop\)[^ \t]* - returns the end position or npos
+	private: size_t skipLoopFile(size_t pos, size_t end) const
+	{
+		if (this->startsWith(pos, end, "\"(loop)")) {
+			size_t quoteEnd = this->masked.find('"', pos + 7);
+			return quoteEnd < end ? quoteEnd + 1 : std::string::npos;
+		} else if (this->startsWith(pos, end, "(loop)")) {
+			return this->skipNonBlanks(pos + 6, end);
+		}
+		return std::string::npos;
+	}
+
+	private: std::string captureLine(size_t lineNum) const
+	{
+		return this->capture(this->lines[lineNum].start, this->lines[lineNum].end + 1);
+	}
+
+	// captured values are taken from the original source code (not the masked one)
+	private: std::string capture(size_t start, size_t end) const
+	{
+		return this->sourceCode.substr(start, end - start);
+	}
+
+	private: bool startsWith(size_t pos, size_t end, std::string const& text) const
+	{
+		return pos + text.size() <= end && this->masked.compare(pos, text.size(), text) == 0;
+	}
+
+	private: static bool isBlank(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	private: size_t skipBlanks(size_t pos, size_t end) const
+	{
+		while (pos < end && this->isBlank(this->masked[pos])) {
+			pos++;
+		}
+		return pos;
+	}
+
+	private: size_t skipNonBlanks(size_t pos, size_t end) const
+	{
+		while (pos < end && !this->isBlank(this->masked[pos])) {
+			pos++;
+		}
+		return pos;
+	}
+
+	private: size_t skipDigits(size_t pos, size_t end, bool digits) const
+	{
+		while (pos < end && (this->masked[pos] >= '0' && this->masked[pos] <= '9') == digits) {
+			pos++;
+		}
+		return pos;
+	}
+
+	private: size_t skipUuid(size_t pos, size_t end) const
+	{
+		while (pos < end && (std::isxdigit(static_cast<unsigned char>(this->masked[pos])) || this->masked[pos] == '-')) {
+			pos++;
+		}
+		return pos;
+	}
+
+	private: bool isWhitespaceOnly(size_t pos) const
+	{
+		return this->masked.find_first_not_of(" \n\t", pos) == std::string::npos;
+	}
+};
+
+#endif /* CONTENT_PARSER_TOKENIZER_H_ */
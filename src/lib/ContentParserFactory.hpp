@@ -23,16 +23,22 @@
 #include <memory>
 
 #include "ContentParser.hpp"
+#include "ContentParser/Result.hpp"
 #include "Exception.hpp"
 
 class ContentParserFactory {
 public:
 	virtual inline ~ContentParserFactory() {};
 
-	virtual std::shared_ptr<ContentParser> create(std::string const& sourceCode) = 0;
-	virtual std::shared_ptr<ContentParser> createByName(std::string const& name) = 0;
+	// all methods are const - results don't depend on previous calls, so they may be used concurrently
+	// throws ParserNotFoundException if no parser matches
+	virtual ContentParser_Result parse(std::string const& sourceCode) const = 0;
+	// throws ItemNotFoundException if there's no parser of the given type
+	virtual ContentParser_Result createDefault(std::string const& type) const = 0;
+	// throws ParserException if the options don't fit into the source template
+	virtual std::string buildSource(ContentParser_Result const& result) const = 0;
+	virtual std::list<std::string> getErrors(ContentParser_Result const& result) const = 0;
 	virtual std::list<std::string> const& getNames() const = 0;
-	virtual std::string getNameByInstance(ContentParser const& instance) const = 0;
 };
 
 class ContentParserFactory_Connection
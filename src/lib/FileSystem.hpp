@@ -19,7 +19,13 @@
 #ifndef FILESYSTEM_H_
 #define FILESYSTEM_H_
 #include <sys/stat.h>
+#include <sys/sendfile.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <list>
@@ -60,6 +66,157 @@ public:
 		}
 	}
 
+	// symlinks are never followed - not even if path itself is one
+	void rmdirRecursive(std::string const& path) {
+		int dirFd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+		DIR* dir = dirFd != -1 ? fdopendir(dirFd) : NULL;
+		if (!dir) {
+			if (dirFd != -1) {
+				close(dirFd);
+			}
+			throw FileReadException("cannot read directory (or it's a symlink): " + path, __FILE__, __LINE__);
+		}
+		struct dirent *entry;
+		while ((entry = readdir(dir))) {
+			if (std::string(entry->d_name) == "." || std::string(entry->d_name) == "..") {
+				continue;
+			}
+			std::string entryPath = path + "/" + entry->d_name;
+			struct stat fileProperties;
+			if (lstat(entryPath.c_str(), &fileProperties) == 0 && S_ISDIR(fileProperties.st_mode)) {
+				this->rmdirRecursive(entryPath);
+			} else {
+				unlink(entryPath.c_str());
+			}
+		}
+		closedir(dir);
+		rmdir(path.c_str());
+	}
+
+	/**
+	 * writes a new file at a path in a world writable directory (like /tmp)
+	 *
+	 * An existing entry is removed first (unlink doesn't follow symlinks) and the
+	 * file is created exclusively, so a symlink planted by another user can't
+	 * redirect the write.
+	 */
+	void writeExclusive(std::string const& path, std::string const& content, mode_t mode = 0644) {
+		unlink(path.c_str());
+		int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, mode);
+		if (fd == -1) {
+			throw FileSaveException("cannot create file: " + path, __FILE__, __LINE__);
+		}
+		size_t written = 0;
+		while (written < content.size()) {
+			ssize_t count = write(fd, content.data() + written, content.size() - written);
+			if (count <= 0 && errno != EINTR) {
+				break;
+			}
+			written += count > 0 ? count : 0;
+		}
+		if (close(fd) != 0 || written != content.size()) {
+			throw FileSaveException("cannot write file: " + path, __FILE__, __LINE__);
+		}
+	}
+
+	/**
+	 * copies a file unless the target already has the same content
+	 *
+	 * The data is copied in kernel space into a temporary file next to the target,
+	 * which replaces the target by rename - so the target is never incomplete.
+	 * The modification time of the source is applied to the target, later calls
+	 * will skip the content comparison when size and time match.
+	 * @return false if the target has been up to date
+	 */
+	bool install(std::string const& srcPath, std::string const& destPath, mode_t mode) {
+		int src = open(srcPath.c_str(), O_RDONLY | O_CLOEXEC);
+		struct stat srcProperties;
+		if (src == -1 || fstat(src, &srcProperties) != 0) {
+			if (src != -1) {
+				close(src);
+			}
+			throw FileReadException("cannot read file: " + srcPath, __FILE__, __LINE__);
+		}
+
+		struct stat destProperties;
+		if (stat(destPath.c_str(), &destProperties) == 0 && S_ISREG(destProperties.st_mode) && destProperties.st_size == srcProperties.st_size) {
+			bool sameTime = destProperties.st_mtim.tv_sec == srcProperties.st_mtim.tv_sec && destProperties.st_mtim.tv_nsec == srcProperties.st_mtim.tv_nsec;
+			if (sameTime || this->hasSameContent(src, destPath)) {
+				close(src);
+				if ((destProperties.st_mode & 07777) != mode) {
+					chmod(destPath.c_str(), mode);
+				}
+				if (!sameTime) {
+					struct timespec times[2] = {srcProperties.st_atim, srcProperties.st_mtim};
+					utimensat(AT_FDCWD, destPath.c_str(), times, 0);
+				}
+				return false;
+			}
+		}
+
+		std::string tmpPath = destPath + ".XXXXXX";
+		int dest = mkostemp(&tmpPath[0], O_CLOEXEC);
+		if (dest == -1) {
+			close(src);
+			throw FileSaveException("cannot create file: " + tmpPath, __FILE__, __LINE__);
+		}
+		struct timespec times[2] = {srcProperties.st_atim, srcProperties.st_mtim};
+		bool success = this->copyData(src, dest, srcProperties.st_size)
+			&& fchmod(dest, mode) == 0
+			&& futimens(dest, times) == 0
+			&& fsync(dest) == 0;
+		success = close(dest) == 0 && success;
+		close(src);
+		if (!success || rename(tmpPath.c_str(), destPath.c_str()) != 0) {
+			unlink(tmpPath.c_str());
+			throw FileSaveException("cannot write file: " + destPath, __FILE__, __LINE__);
+		}
+		return true;
+	}
+
+private:
+	bool copyData(int src, int dest, off_t size) {
+		off_t copied = 0;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+		while (copied < size) {
+			ssize_t count = copy_file_range(src, NULL, dest, NULL, size - copied, 0);
+			if (count <= 0) {
+				break;
+			}
+			copied += count;
+		}
+#endif
+		// not supported between these file systems (or by the kernel) - use sendfile instead
+		while (copied < size) {
+			off_t offset = copied;
+			ssize_t count = sendfile(dest, src, &offset, size - copied);
+			if (count <= 0) {
+				return false;
+			}
+			copied += count;
+		}
+		return true;
+	}
+
+	bool hasSameContent(int src, std::string const& path) {
+		int other = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (other == -1) {
+			return false;
+		}
+		// the sizes are already known to be equal
+		char buffer1[16384], buffer2[16384];
+		off_t offset = 0;
+		bool same = true;
+		ssize_t count1;
+		while (same && (count1 = pread(src, buffer1, sizeof(buffer1), offset)) != 0) {
+			ssize_t count2 = count1 > 0 ? pread(other, buffer2, count1, offset) : -1;
+			same = count1 > 0 && count1 == count2 && memcmp(buffer1, buffer2, count1) == 0;
+			offset += count1;
+		}
+		close(other);
+		return same;
+	}
+
 };
 
 #endif /* FILESYSTEM_H_ */
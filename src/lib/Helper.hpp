@@ -19,10 +19,10 @@
 #define HELPER_H_INCLUDED
 
 #include <cstdio>
-#include <openssl/md5.h>
 #include <string>
 #include <map>
 #include "Exception.hpp"
+#include "Md5.hpp"
 
 # define ASSERT_VOID_CAST static_cast<void>
 
@@ -45,30 +45,7 @@ class Helper {
 	}
 
 	public: static std::string md5(std::string const& input) {
-		unsigned char buf[16];
-		unsigned char* cStr = new unsigned char[input.length() + 1];
-		for (int i = 0; i < input.length(); i++) {
-			cStr[i] = static_cast<unsigned char>(input[i]);
-		}
-		MD5(cStr, input.length(), buf);
-
-		std::string result;
-		for (int i = 0; i < 16; i++) {
-			unsigned int a = (buf[i] - (buf[i] % 16)) / 16;
-			if (a <= 9) {
-				result += '0' + a;
-			} else {
-				result += 'a' + a - 10;
-			}
-			unsigned int b = (buf[i] % 16);
-			if (b <= 9) {
-				result += '0' + b;
-			} else {
-				result += 'a' + b - 10;
-			}
-		}
-		assert(result.length() == 32);
-		return result;
+		return Md5::hash(input);
 	}
 
 	public: static std::string str_replace(const std::string &search, const std::string &replace, std::string subject) {
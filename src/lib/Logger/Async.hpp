@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef ASYNC_LOGGER_H_
+#define ASYNC_LOGGER_H_
+#include "Stream.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+/**
+ * Logger_Stream variant which doesn't block the calling threads on output
+ *
+ * Messages are formatted (timestamp, thread tag) by the caller and put into a bounded
+ * lock-free multi producer ring buffer. A background thread writes them to the stream.
+ * Errors are flushed synchronously, the remaining messages are written on destruction.
+ */
+class Logger_Async : public Logger_Stream {
+	struct Slot {
+		std::atomic<size_t> sequence;
+		std::string message;
+	};
+
+	std::unique_ptr<Slot[]> buffer;
+	size_t bufferMask;
+	std::atomic<size_t> enqueuePos;
+	size_t dequeuePos; // only used by the flusher thread
+	size_t flushedPos; // guarded by flushMutex
+	std::atomic<bool> stopRequested;
+	std::atomic<int> threadCount;
+	std::mutex flushMutex;
+	std::condition_variable wakeupCondition;
+	std::condition_variable flushedCondition;
+	std::thread flusher;
+public:
+	// bufferSize must be a power of two
+	Logger_Async(std::ostream& stream, size_t bufferSize = 4096) :
+		Logger_Stream(stream),
+		buffer(new Slot[bufferSize]),
+		bufferMask(bufferSize - 1),
+		enqueuePos(0),
+		dequeuePos(0),
+		flushedPos(0),
+		stopRequested(false),
+		threadCount(0)
+	{
+		for (size_t i = 0; i < bufferSize; i++) {
+			this->buffer[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		this->flusher = std::thread(&Logger_Async::runFlusher, this);
+	}
+
+	~Logger_Async() {
+		{
+			std::lock_guard<std::mutex> lock(this->flushMutex);
+			this->stopRequested = true;
+		}
+		this->wakeupCondition.notify_one();
+		this->flusher.join();
+	}
+
+	void log(std::string const& message, Logger::Priority prio) {
+		if (!this->isLogged(prio)) {
+			return;
+		}
+		size_t pos = this->push(this->formatMessage(message, prio));
+		if (prio == Logger::ERROR || prio == Logger::EXCEPTION) {
+			this->flush(pos + 1);
+		}
+	}
+
+	void logActionBegin(std::string const& controller, std::string const& action) {
+		this->beginAction(controller + "/" + action);
+	}
+
+	void logActionEnd() {
+		this->endAction(false);
+	}
+
+	void logActionBeginThreaded(std::string const& controller, std::string const& action) {
+		this->beginAction(controller + "/" + action + " [threaded]");
+	}
+
+	void logActionEndThreaded() {
+		this->endAction(true);
+	}
+
+	// waits until all messages logged so far have been written
+	void flush() {
+		this->flush(this->enqueuePos.load());
+	}
+
+private:
+	// each thread has its own stack of running actions
+	std::vector<std::string>& getActionStack() {
+		static thread_local std::vector<std::string> actionStack;
+		return actionStack;
+	}
+
+	int getThreadTag() {
+		static thread_local int threadTag = 0;
+		if (threadTag == 0) {
+			threadTag = ++this->threadCount;
+		}
+		return threadTag;
+	}
+
+	void beginAction(std::string const& name) {
+		std::vector<std::string>& actionStack = this->getActionStack();
+		actionStack.push_back(name);
+		if (this->isActionLogged()) {
+			this->push(std::string(actionStack.size(), ' ') + "-> " + name);
+		}
+	}
+
+	void endAction(bool logActionName) {
+		std::vector<std::string>& actionStack = this->getActionStack();
+		if (actionStack.empty()) {
+			return;
+		}
+		if (this->isActionLogged() && logActionName) {
+			this->push(std::string(actionStack.size(), ' ') + "<- " + actionStack.back());
+		}
+		actionStack.pop_back();
+		// like Logger_Stream: separate the top level actions by a blank line
+		if (this->isActionLogged() && !logActionName && actionStack.empty()) {
+			this->push("", false);
+		}
+	}
+
+	std::string buildPrefix() {
+		auto now = std::chrono::system_clock::now();
+		std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+		int milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+		struct tm localTime;
+		localtime_r(&seconds, &localTime);
+		char result[64];
+		snprintf(result, sizeof(result), "%02d:%02d:%02d.%03d [T%d] ", localTime.tm_hour, localTime.tm_min, localTime.tm_sec, milliseconds, this->getThreadTag());
+		return result;
+	}
+
+	// returns the position of the message in the queue
+	size_t push(std::string const& message, bool addPrefix = true) {
+		std::string line = (addPrefix ? this->buildPrefix() : "") + message + "\n";
+		size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+		Slot* slot;
+		while (true) {
+			slot = &this->buffer[pos & this->bufferMask];
+			size_t sequence = slot->sequence.load(std::memory_order_acquire);
+			long diff = long(sequence) - long(pos);
+			if (diff == 0) {
+				if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					break;
+				}
+			} else if (diff < 0) { // buffer full - let the flusher catch up
+				this->wakeupCondition.notify_one();
+				std::this_thread::yield();
+				pos = this->enqueuePos.load(std::memory_order_relaxed);
+			} else {
+				pos = this->enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		slot->message.swap(line);
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return pos;
+	}
+
+	void flush(size_t targetPos) {
+		std::unique_lock<std::mutex> lock(this->flushMutex);
+		this->wakeupCondition.notify_one();
+		while (this->flushedPos < targetPos && !this->stopRequested) {
+			this->flushedCondition.wait(lock);
+		}
+	}
+
+	void runFlusher() {
+		bool written = false;
+		while (true) {
+			Slot& slot = this->buffer[this->dequeuePos & this->bufferMask];
+			if (slot.sequence.load(std::memory_order_acquire) == this->dequeuePos + 1) {
+				*this->stream << slot.message;
+				slot.message.clear();
+				slot.sequence.store(this->dequeuePos + this->bufferMask + 1, std::memory_order_release);
+				this->dequeuePos++;
+				written = true;
+				continue;
+			}
+
+			// nothing to write (or the next message isn't completely stored yet)
+			if (written) {
+				this->stream->flush();
+				written = false;
+			}
+			std::unique_lock<std::mutex> lock(this->flushMutex);
+			this->flushedPos = this->dequeuePos;
+			this->flushedCondition.notify_all();
+			if (this->stopRequested && this->enqueuePos.load() == this->dequeuePos) {
+				break;
+			}
+			this->wakeupCondition.wait_for(lock, std::chrono::milliseconds(20));
+		}
+	}
+};
+
+#endif
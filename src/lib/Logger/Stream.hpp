@@ -23,6 +23,7 @@
 #include <string>
 
 class Logger_Stream : public Logger {
+protected:
 	std::ostream* stream;
 	int actionStackDepth;
 public:
@@ -36,34 +37,14 @@ public:
 	Logger_Stream(std::ostream& stream) : stream(&stream), actionStackDepth(0), logLevel(LOG_NOTHING) {}
 
 	void log(std::string const& message, Logger::Priority prio) {
-		if (prio != ERROR && (
-			this->logLevel == LOG_NOTHING ||
-			(this->logLevel == LOG_DEBUG_ONLY && prio != Logger::DEBUG && prio != Logger::EXCEPTION) ||
-			(this->logLevel == LOG_IMPORTANT && prio != Logger::IMPORTANT_EVENT) ||
-			(this->logLevel == LOG_EVENT && prio != Logger::EVENT && prio != Logger::IMPORTANT_EVENT))) {
+		if (!this->isLogged(prio)) {
 			return;
 		}
-		if (prio == Logger::IMPORTANT_EVENT) {
-			*this->stream << " *** ";
-		} else if (prio == Logger::EVENT) {
-			*this->stream << "   * ";
-		} else {
-			*this->stream << "     ";
-		}
-	
-		if (prio == Logger::INFO) {
-			*this->stream << "[";
-		}
-		*this->stream << message;
-		if (prio == Logger::INFO) {
-			*this->stream << "]";
-		}
-	
-		*this->stream << std::endl;
+		*this->stream << this->formatMessage(message, prio) << std::endl;
 	}
 
 	void logActionBegin(std::string const& controller, std::string const& action) {
-		if (this->logLevel == LOG_DEBUG_ONLY || this->logLevel == LOG_VERBOSE) {
+		if (this->isActionLogged()) {
 			actionStackDepth++;
 			for (int i = 0; i < actionStackDepth; i++) {
 				*this->stream << " ";
@@ -73,7 +54,7 @@ public:
 	}
 
 	void logActionEnd() {
-		if (this->logLevel == LOG_DEBUG_ONLY || this->logLevel == LOG_VERBOSE) {
+		if (this->isActionLogged()) {
 			if (actionStackDepth) {
 				actionStackDepth--;
 			}
@@ -95,6 +76,37 @@ public:
 		this->logLevel = level;
 	}
 
+protected:
+	bool isLogged(Logger::Priority prio) const {
+		return prio == ERROR || !(
+			this->logLevel == LOG_NOTHING ||
+			(this->logLevel == LOG_DEBUG_ONLY && prio != Logger::DEBUG && prio != Logger::EXCEPTION) ||
+			(this->logLevel == LOG_IMPORTANT && prio != Logger::IMPORTANT_EVENT) ||
+			(this->logLevel == LOG_EVENT && prio != Logger::EVENT && prio != Logger::IMPORTANT_EVENT));
+	}
+
+	bool isActionLogged() const {
+		return this->logLevel == LOG_DEBUG_ONLY || this->logLevel == LOG_VERBOSE;
+	}
+
+	std::string formatMessage(std::string const& message, Logger::Priority prio) const {
+		std::string result;
+		if (prio == Logger::IMPORTANT_EVENT) {
+			result = " *** ";
+		} else if (prio == Logger::EVENT) {
+			result = "   * ";
+		} else {
+			result = "     ";
+		}
+
+		if (prio == Logger::INFO) {
+			result += "[" + message + "]";
+		} else {
+			result += message;
+		}
+		return result;
+	}
+
 };
 
 #endif
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+#ifndef MD5_H_INCLUDED
+#define MD5_H_INCLUDED
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * in-tree implementation of the MD5 message digest (RFC 1321)
+ *
+ * Used to identify menuentries by their content. Keeping it in the tree
+ * avoids linking libcrypto into the proxy binary.
+ */
+class Md5
+{
+	private: uint32_t state[4];
+	private: uint64_t length;
+	private: unsigned char buffer[64];
+	private: int bufferSize;
+
+	public: Md5()
+	{
+		this->reset();
+	}
+
+	public: void reset()
+	{
+		this->state[0] = 0x67452301;
+		this->state[1] = 0xefcdab89;
+		this->state[2] = 0x98badcfe;
+		this->state[3] = 0x10325476;
+		this->length = 0;
+		this->bufferSize = 0;
+	}
+
+	public: void update(unsigned char const* data, size_t size)
+	{
+		this->length += size;
+		while (size) {
+			size_t chunk = 64 - this->bufferSize;
+			if (chunk > size) {
+				chunk = size;
+			}
+			memcpy(this->buffer + this->bufferSize, data, chunk);
+			this->bufferSize += chunk;
+			data += chunk;
+			size -= chunk;
+			if (this->bufferSize == 64) {
+				this->transform(this->buffer);
+				this->bufferSize = 0;
+			}
+		}
+	}
+
+	public: void update(std::string const& data)
+	{
+		this->update(reinterpret_cast<unsigned char const*>(data.data()), data.size());
+	}
+
+	public: void finish(unsigned char digest[16])
+	{
+		uint64_t bitLength = this->length * 8;
+		unsigned char padding[72] = {0x80};
+		size_t paddingSize = this->bufferSize < 56 ? 56 - this->bufferSize : 120 - this->bufferSize;
+		for (int i = 0; i < 8; i++) {
+			padding[paddingSize + i] = static_cast<unsigned char>(bitLength >> (i * 8));
+		}
+		this->update(padding, paddingSize + 8);
+
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				digest[i * 4 + j] = static_cast<unsigned char>(this->state[i] >> (j * 8));
+			}
+		}
+		this->reset();
+	}
+
+	public: std::string hexdigest()
+	{
+		unsigned char digest[16];
+		this->finish(digest);
+
+		static char const hexChars[] = "0123456789abcdef";
+		std::string result(32, '0');
+		for (int i = 0; i < 16; i++) {
+			result[i * 2] = hexChars[digest[i] >> 4];
+			result[i * 2 + 1] = hexChars[digest[i] & 0x0f];
+		}
+		return result;
+	}
+
+	public: static std::string hash(std::string const& input)
+	{
+		Md5 md5;
+		md5.update(input);
+		return md5.hexdigest();
+	}
+
+	private: static uint32_t rotateLeft(uint32_t value, int bits)
+	{
+		return (value << bits) | (value >> (32 - bits));
+	}
+
+	private: void transform(unsigned char const block[64])
+	{
+		static uint32_t const k[64] = {
+			0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+			0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+			0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+			0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+			0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+			0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+			0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+			0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+		};
+		static int const shifts[64] = {
+			7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+			5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
+			4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+			6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
+		};
+
+		uint32_t m[16];
+		for (int i = 0; i < 16; i++) {
+			m[i] = uint32_t(block[i * 4])
+				| (uint32_t(block[i * 4 + 1]) << 8)
+				| (uint32_t(block[i * 4 + 2]) << 16)
+				| (uint32_t(block[i * 4 + 3]) << 24);
+		}
+
+		uint32_t a = this->state[0], b = this->state[1], c = this->state[2], d = this->state[3];
+		for (int i = 0; i < 64; i++) {
+			uint32_t f;
+			int g;
+			if (i < 16) {
+				f = (b & c) | (~b & d);
+				g = i;
+			} else if (i < 32) {
+				f = (d & b) | (~d & c);
+				g = (5 * i + 1) % 16;
+			} else if (i < 48) {
+				f = b ^ c ^ d;
+				g = (3 * i + 5) % 16;
+			} else {
+				f = c ^ (b | ~d);
+				g = (7 * i) % 16;
+			}
+			uint32_t temp = d;
+			d = c;
+			c = b;
+			b = b + Md5::rotateLeft(a + f + k[i] + m[g], shifts[i]);
+			a = temp;
+		}
+
+		this->state[0] += a;
+		this->state[1] += b;
+		this->state[2] += c;
+		this->state[3] += d;
+	}
+};
+
+#endif
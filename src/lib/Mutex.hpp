@@ -30,6 +30,11 @@ public:
 	virtual void lock() = 0;
 	virtual bool trylock() = 0;
 	virtual void unlock() = 0;
+
+	// shared locks can be held by multiple readers at once, but not together with lock()
+	virtual void lockShared() = 0;
+	virtual bool trylockShared() = 0;
+	virtual void unlockShared() = 0;
 };
 
 class Mutex_Connection
@@ -18,23 +18,35 @@
 
 #ifndef GLIBMUTEX_H_
 #define GLIBMUTEX_H_
-#include <glibmm/thread.h>
+#include <glibmm/threads.h>
 #include "../Mutex.hpp"
 
 class Mutex_GLib : public Mutex {
 protected:
-	Glib::Mutex mutex;
+	Glib::Threads::RWLock mutex;
 public:
 	void lock() {
-		this->mutex.lock();
+		this->mutex.writer_lock();
 	}
 
 	bool trylock() {
-		return this->mutex.trylock();
+		return this->mutex.writer_trylock();
 	}
 
 	void unlock() {
-		this->mutex.unlock();
+		this->mutex.writer_unlock();
+	}
+
+	void lockShared() {
+		this->mutex.reader_lock();
+	}
+
+	bool trylockShared() {
+		return this->mutex.reader_trylock();
+	}
+
+	void unlockShared() {
+		this->mutex.reader_unlock();
 	}
 
 };
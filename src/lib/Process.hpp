@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef PROCESS_H_INCLUDED
+#define PROCESS_H_INCLUDED
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <spawn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "Exception.hpp"
+
+extern char** environ;
+
+/**
+ * runs a shell command in its own process group
+ *
+ * stdout is provided as stream, stderr is collected in memory. Both pipes are
+ * read non-blocking, so a cancel request or an exceeded timeout is noticed
+ * even if the command doesn't write anything (e.g. a hanging os-prober).
+ * In this case the whole process group gets killed and the stream ends.
+ * Background processes started by the command may inherit the pipes, so
+ * they aren't read until EOF once the command itself has exited.
+ */
+class Process
+{
+	private: std::string command;
+	private: pid_t pid;
+	private: int stdoutFd, stderrFd;
+	private: FILE* output;
+	private: std::string errorOutput;
+	private: std::chrono::steady_clock::time_point deadline;
+	private: bool timedOut, cancelled;
+	private: int status;
+
+	public: int timeout; // seconds, 0 = unlimited
+	public: std::atomic<bool> const* cancelRequested;
+
+	public: Process(std::string const& command) :
+		command(command), pid(-1), stdoutFd(-1), stderrFd(-1), output(NULL),
+		timedOut(false), cancelled(false), status(-1), timeout(0), cancelRequested(NULL)
+	{}
+
+	public: Process(Process const&) = delete;
+	public: Process& operator=(Process const&) = delete;
+
+	public: ~Process()
+	{
+		if (this->pid > 0) {
+			this->kill();
+			this->wait();
+		}
+	}
+
+	/**
+	 * @return stream of the stdout data, closed by wait()
+	 */
+	public: FILE* start()
+	{
+		int stdoutPipe[2], stderrPipe[2];
+		if (pipe2(stdoutPipe, O_CLOEXEC) != 0) {
+			throw CmdExecException("cannot create pipe for " + this->command, __FILE__, __LINE__);
+		}
+		if (pipe2(stderrPipe, O_CLOEXEC) != 0) {
+			close(stdoutPipe[0]);
+			close(stdoutPipe[1]);
+			throw CmdExecException("cannot create pipe for " + this->command, __FILE__, __LINE__);
+		}
+
+		posix_spawn_file_actions_t fileActions;
+		posix_spawn_file_actions_init(&fileActions);
+		posix_spawn_file_actions_adddup2(&fileActions, stdoutPipe[1], STDOUT_FILENO);
+		posix_spawn_file_actions_adddup2(&fileActions, stderrPipe[1], STDERR_FILENO);
+
+		posix_spawnattr_t attributes;
+		posix_spawnattr_init(&attributes);
+		sigset_t defaultSignals, signalMask;
+		sigemptyset(&defaultSignals);
+		sigaddset(&defaultSignals, SIGPIPE);
+		sigemptyset(&signalMask);
+		posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+		posix_spawnattr_setsigmask(&attributes, &signalMask);
+		posix_spawnattr_setpgroup(&attributes, 0);
+		posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+		char const* argv[] = {"/bin/sh", "-c", this->command.c_str(), NULL};
+		int spawnResult = posix_spawn(&this->pid, "/bin/sh", &fileActions, &attributes, const_cast<char* const*>(argv), environ);
+
+		posix_spawn_file_actions_destroy(&fileActions);
+		posix_spawnattr_destroy(&attributes);
+		close(stdoutPipe[1]);
+		close(stderrPipe[1]);
+
+		if (spawnResult != 0) {
+			this->pid = -1;
+			close(stdoutPipe[0]);
+			close(stderrPipe[0]);
+			throw CmdExecException("cannot execute " + this->command, __FILE__, __LINE__);
+		}
+
+		this->stdoutFd = stdoutPipe[0];
+		this->stderrFd = stderrPipe[0];
+		fcntl(this->stdoutFd, F_SETFL, fcntl(this->stdoutFd, F_GETFL) | O_NONBLOCK);
+		fcntl(this->stderrFd, F_SETFL, fcntl(this->stderrFd, F_GETFL) | O_NONBLOCK);
+		this->deadline = std::chrono::steady_clock::now() + std::chrono::seconds(this->timeout);
+
+		cookie_io_functions_t streamFunctions = {&Process::readStream, NULL, NULL, NULL};
+		this->output = fopencookie(this, "r", streamFunctions);
+		return this->output;
+	}
+
+	/**
+	 * closes the output stream and waits until the command is finished
+	 * @return exit status (like pclose)
+	 */
+	public: int wait()
+	{
+		if (this->output) {
+			fclose(this->output);
+			this->output = NULL;
+		}
+		this->closeFd(this->stdoutFd); // the command gets SIGPIPE if it still writes
+
+		while (this->pid > 0 && !this->reap()) {
+			this->checkAbort();
+			if (this->stderrFd != -1) {
+				this->poll(); // waits up to 100ms
+			} else {
+				usleep(10000);
+			}
+		}
+		this->drainErrorOutput(100);
+		this->closeFd(this->stderrFd);
+		return this->status;
+	}
+
+	/**
+	 * kills the whole process group
+	 */
+	public: void kill()
+	{
+		if (this->pid > 0) {
+			killpg(this->pid, SIGKILL);
+		}
+	}
+
+	public: std::string const& getErrorOutput() const
+	{
+		return this->errorOutput;
+	}
+
+	public: bool isTimedOut() const
+	{
+		return this->timedOut;
+	}
+
+	public: bool isCancelled() const
+	{
+		return this->cancelled;
+	}
+
+	private: static ssize_t readStream(void* cookie, char* buffer, size_t size)
+	{
+		return static_cast<Process*>(cookie)->read(buffer, size);
+	}
+
+	private: ssize_t read(char* buffer, size_t size)
+	{
+		while (this->stdoutFd != -1) {
+			if (this->checkAbort()) {
+				this->closeFd(this->stdoutFd);
+				break;
+			}
+			ssize_t result = ::read(this->stdoutFd, buffer, size);
+			if (result > 0) {
+				return result;
+			} else if (result == 0 || (errno != EAGAIN && errno != EINTR)) {
+				this->closeFd(this->stdoutFd);
+			} else if (this->pid == -1) {
+				// everything written by the command has been read - don't wait for background processes
+				this->closeFd(this->stdoutFd);
+			} else if (!this->reap()) {
+				this->poll();
+			}
+		}
+		return 0;
+	}
+
+	/**
+	 * checks whether the command has exited, without blocking
+	 * @return true if it has been reaped (the exit status is stored)
+	 */
+	private: bool reap()
+	{
+		if (this->pid <= 0) {
+			return true;
+		}
+		int status = -1;
+		pid_t result = waitpid(this->pid, &status, WNOHANG);
+		if (result == this->pid || (result == -1 && errno != EINTR)) {
+			this->status = result == this->pid ? status : -1;
+			this->pid = -1;
+			return true;
+		}
+		return false;
+	}
+
+	// reads the data already written to stderr - waits at most maxWait milliseconds for more
+	private: void drainErrorOutput(int maxWait)
+	{
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(maxWait);
+		char buffer[4096];
+		while (this->stderrFd != -1) {
+			ssize_t result = ::read(this->stderrFd, buffer, sizeof(buffer));
+			if (result > 0) {
+				this->errorOutput.append(buffer, result);
+				if (std::chrono::steady_clock::now() >= end) {
+					break;
+				}
+				continue;
+			} else if (result == 0 || (errno != EAGAIN && errno != EINTR)) {
+				this->closeFd(this->stderrFd);
+				break;
+			}
+			int remaining = std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count();
+			if (remaining <= 0) {
+				break;
+			}
+			struct pollfd fd = {this->stderrFd, POLLIN, 0};
+			::poll(&fd, 1, remaining);
+		}
+	}
+
+	// waits up to 100ms for new data and collects everything written to stderr
+	private: void poll()
+	{
+		struct pollfd fds[2];
+		nfds_t count = 0;
+		if (this->stdoutFd != -1) {
+			fds[count].fd = this->stdoutFd;
+			fds[count++].events = POLLIN;
+		}
+		if (this->stderrFd != -1) {
+			fds[count].fd = this->stderrFd;
+			fds[count++].events = POLLIN;
+		}
+		if (count == 0 || ::poll(fds, count, 100) <= 0 || this->stderrFd == -1) {
+			return;
+		}
+
+		char buffer[4096];
+		ssize_t result;
+		while ((result = ::read(this->stderrFd, buffer, sizeof(buffer))) > 0) {
+			this->errorOutput.append(buffer, result);
+		}
+		if (result == 0 || (errno != EAGAIN && errno != EINTR)) {
+			this->closeFd(this->stderrFd);
+		}
+	}
+
+	private: bool checkAbort()
+	{
+		if (!this->cancelled && this->cancelRequested && *this->cancelRequested) {
+			this->cancelled = true;
+			this->kill();
+		}
+		if (!this->timedOut && this->timeout > 0 && std::chrono::steady_clock::now() > this->deadline) {
+			this->timedOut = true;
+			this->kill();
+		}
+		return this->cancelled || this->timedOut;
+	}
+
+	private: void closeFd(int& fd)
+	{
+		if (fd != -1) {
+			close(fd);
+			fd = -1;
+		}
+	}
+};
+
+#endif
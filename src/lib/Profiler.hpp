@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef PROFILER_H_INCLUDED
+#define PROFILER_H_INCLUDED
+
+#include <string>
+#include <memory>
+
+class Profiler
+{
+	public: virtual inline ~Profiler() {};
+
+	/**
+	 * stays empty unless profiling has been requested - timers are no-ops then
+	 */
+	public: static std::shared_ptr<Profiler>& getInstance()
+	{
+		static std::shared_ptr<Profiler> profiler;
+
+		return profiler;
+	}
+
+	// begin and end must be nested correctly per thread
+	public: virtual void begin(std::string const& name, std::string const& category) = 0;
+	public: virtual void end() = 0;
+};
+
+/**
+ * times the lifetime of the object or the time until stop() is called
+ */
+class Profiler_Scope
+{
+	private: std::shared_ptr<Profiler> profiler;
+
+	public: Profiler_Scope(std::string const& name, std::string const& category = "phase") :
+		profiler(Profiler::getInstance())
+	{
+		if (this->profiler) {
+			this->profiler->begin(name, category);
+		}
+	}
+
+	public: ~Profiler_Scope()
+	{
+		this->stop();
+	}
+
+	public: void stop()
+	{
+		if (this->profiler) {
+			this->profiler->end();
+			this->profiler = nullptr;
+		}
+	}
+
+	private: Profiler_Scope(Profiler_Scope const&);
+	private: Profiler_Scope& operator=(Profiler_Scope const&);
+};
+
+#endif
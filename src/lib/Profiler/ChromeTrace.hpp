@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef PROFILER_CHROMETRACE_H_INCLUDED
+#define PROFILER_CHROMETRACE_H_INCLUDED
+#include "../Profiler.hpp"
+#include "../Exception.hpp"
+#include "../FileSystem.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+
+/**
+ * collects begin/end events and writes them in the Trace Event Format
+ * (loadable by chrome://tracing, Perfetto or speedscope)
+ */
+class Profiler_ChromeTrace : public Profiler
+{
+	private: struct Event {
+		char phase;
+		std::string name;
+		std::string category;
+		long long timestamp;
+		int threadId;
+	};
+
+	private: std::vector<Event> events;
+	private: std::map<std::thread::id, int> threadIds;
+	private: std::chrono::steady_clock::time_point startTime;
+	private: std::mutex mutex;
+
+	public: Profiler_ChromeTrace() : startTime(std::chrono::steady_clock::now()) {}
+
+	public: void begin(std::string const& name, std::string const& category)
+	{
+		this->addEvent('B', name, category);
+	}
+
+	public: void end()
+	{
+		this->addEvent('E', "", "");
+	}
+
+	public: void writeFile(std::string const& path)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::ostringstream file;
+		file << "{\"traceEvents\":[";
+		for (std::vector<Event>::iterator iter = this->events.begin(); iter != this->events.end(); iter++) {
+			file << (iter == this->events.begin() ? "\n" : ",\n");
+			file << "{\"ph\":\"" << iter->phase << "\",\"ts\":" << iter->timestamp << ",\"pid\":1,\"tid\":" << iter->threadId;
+			if (iter->phase == 'B') {
+				file << ",\"name\":\"" << this->escape(iter->name) << "\",\"cat\":\"" << this->escape(iter->category) << "\"";
+			}
+			file << "}";
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		// the default path is in /tmp - never follow a symlink planted there
+		FileSystem().writeExclusive(path, file.str());
+	}
+
+	private: void addEvent(char phase, std::string const& name, std::string const& category)
+	{
+		long long timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->startTime).count();
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		std::map<std::thread::id, int>::iterator threadIter = this->threadIds.find(std::this_thread::get_id());
+		int threadId;
+		if (threadIter == this->threadIds.end()) {
+			threadId = this->threadIds.size() + 1;
+			this->threadIds[std::this_thread::get_id()] = threadId;
+		} else {
+			threadId = threadIter->second;
+		}
+
+		Event event = {phase, name, category, timestamp, threadId};
+		this->events.push_back(event);
+	}
+
+	private: std::string escape(std::string const& value) const
+	{
+		std::ostringstream result;
+		for (std::string::const_iterator iter = value.begin(); iter != value.end(); iter++) {
+			if (*iter == '"' || *iter == '\\') {
+				result << '\\' << *iter;
+			} else if (static_cast<unsigned char>(*iter) < 0x20) {
+				result << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(*iter) << std::dec;
+			} else {
+				result << *iter;
+			}
+		}
+		return result.str();
+	}
+};
+
+#endif
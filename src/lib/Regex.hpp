@@ -39,6 +39,9 @@ class Regex {
 		char const& escapeCharacter = '\0',
 		char const& replaceCharacter = '\0'
 	) = 0;
+
+	// prepares the given pattern for later use - to be called for static patterns used on hot paths
+	public: virtual void precompile(std::string const& pattern) = 0;
 };
 
 class Regex_RegexConnection
@@ -18,7 +18,7 @@
 
 #ifndef GLIBREGEX_H_
 #define GLIBREGEX_H_
-#include <glibmm/thread.h>
+#include <glibmm/threads.h>
 
 #include <string>
 #include <vector>
@@ -33,6 +33,49 @@
 class Regex_GLib :
 	public Regex
 {
+	// compiled patterns are shared between threads - GRegex is immutable after compilation
+	private: std::map<std::pair<std::string, int>, GRegex*> compiledPatterns;
+	private: Glib::Threads::Mutex compiledPatternsMutex;
+	private: GRegexCompileFlags compileFlags;
+
+	// optimizing costs compile time but pays off for patterns used many times (cached patterns are)
+	public: Regex_GLib(bool optimize = true) :
+		compileFlags(optimize ? G_REGEX_OPTIMIZE : GRegexCompileFlags(0))
+	{}
+
+	public: ~Regex_GLib()
+	{
+		for (std::map<std::pair<std::string, int>, GRegex*>::iterator iter = this->compiledPatterns.begin(); iter != this->compiledPatterns.end(); iter++) {
+			g_regex_unref(iter->second);
+		}
+	}
+
+	public: void precompile(std::string const& pattern)
+	{
+		g_regex_unref(this->getCompiledPattern(pattern));
+	}
+
+	// returns a new reference to the compiled pattern - to be released using g_regex_unref
+	private: GRegex* getCompiledPattern(std::string const& pattern)
+	{
+		std::pair<std::string, int> key(pattern, int(this->compileFlags));
+		Glib::Threads::Mutex::Lock lock(this->compiledPatternsMutex);
+		std::map<std::pair<std::string, int>, GRegex*>::iterator iter = this->compiledPatterns.find(key);
+		if (iter != this->compiledPatterns.end()) {
+			return g_regex_ref(iter->second);
+		}
+
+		GError* error = NULL;
+		GRegex* gr = g_regex_new(pattern.c_str(), this->compileFlags, GRegexMatchFlags(0), &error);
+		if (gr == NULL) {
+			std::string message = error ? error->message : "unknown error";
+			g_clear_error(&error);
+			throw LogicException("invalid regex pattern " + pattern + ": " + message, __FILE__, __LINE__);
+		}
+		this->compiledPatterns[key] = gr;
+		return g_regex_ref(gr);
+	}
+
 	public: std::vector<std::string> match(
 		std::string const& pattern,
 		std::string const& str,
@@ -42,12 +85,15 @@ class Regex_GLib :
 	{
 		std::vector<std::string> result;
 		GMatchInfo* mi = NULL;
-		GRegex* gr = g_regex_new(pattern.c_str(), GRegexCompileFlags(0), GRegexMatchFlags(0), NULL);
+		GRegex* gr = this->getCompiledPattern(pattern);
 		std::string escapedStr = escapeCharacter == '\0' ? "" : Helper::str_replace_escape(str, escapeCharacter, replaceCharacter);
 		const gchar* matchStr = escapeCharacter == '\0' ? str.c_str() : escapedStr.c_str();
 		bool success = g_regex_match(gr, matchStr, GRegexMatchFlags(0), &mi);
-		if (!success)
+		if (!success) {
+			g_match_info_free(mi);
+			g_regex_unref(gr);
 			throw RegExNotMatchedException("RegEx doesn't match", __FILE__, __LINE__);
+		}
 
 		gint match_count = g_match_info_get_match_count(mi);
 		gint offset = 0;
@@ -73,14 +119,17 @@ class Regex_GLib :
 	{
 		std::string result = str;
 		GMatchInfo* mi = NULL;
-		GRegex* gr = g_regex_new(pattern.c_str(), GRegexCompileFlags(0), GRegexMatchFlags(0), NULL);
+		GRegex* gr = this->getCompiledPattern(pattern);
 
 		std::string escapedStr = escapeCharacter == '\0' ? "" : Helper::str_replace_escape(str, escapeCharacter, replaceCharacter);
 		const gchar* matchStr = escapeCharacter == '\0' ? str.c_str() : escapedStr.c_str();
 
 		bool success = g_regex_match(gr, matchStr, GRegexMatchFlags(0), &mi);
-		if (!success)
+		if (!success) {
+			g_match_info_free(mi);
+			g_regex_unref(gr);
 			throw RegExNotMatchedException("RegEx doesn't match", __FILE__, __LINE__);
+		}
 
 		gint match_count = g_match_info_get_match_count(mi);
 		gint offset = 0;
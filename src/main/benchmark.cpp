@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <list>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <algorithm>
+#include "../Benchmark/AllocationCounter.hpp"
+#include "../Benchmark/Fixture.hpp"
+#include "../Benchmark/Runner.hpp"
+#include "../Benchmark/StdRegex.hpp"
+#include "../Benchmark/ContentParserCheck.hpp"
+#include "../Model/Env.hpp"
+#include "../Model/ListCfg.hpp"
+
+void* operator new(std::size_t size) {
+	Benchmark_AllocationCounter::add(size);
+	void* result = std::malloc(size ? size : 1);
+	if (result == NULL) {
+		throw std::bad_alloc();
+	}
+	return result;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+std::shared_ptr<Model_Env> createEnv(Benchmark_Fixture const& fixture) {
+	auto env = std::make_shared<Model_Env>();
+	env->cmd_prefix = "";
+	env->cfg_dir_prefix = "";
+	env->setProperties(fixture.getEnvProperties());
+	env->update_cmd = env->mkconfig_cmd + " -o \"" + env->output_config_file + "\"";
+	return env;
+}
+
+std::shared_ptr<Model_ListCfg> createListCfg(std::shared_ptr<Model_Env> env) {
+	auto listCfg = std::make_shared<Model_ListCfg>();
+	listCfg->setEnv(env);
+	listCfg->ignoreLock = true;
+	listCfg->verbose = false;
+	return listCfg;
+}
+
+void collectEntryContents(std::list<std::shared_ptr<Model_Entry>> const& entries, std::list<std::string>& contents) {
+	for (auto entry : entries) {
+		if (entry->type == Model_Entry::MENUENTRY) {
+			contents.push_back(entry->content);
+		}
+		collectEntryContents(entry->subEntries, contents);
+	}
+}
+
+void runFixture(Benchmark_Runner& runner, Benchmark_Fixture::Params const& params, std::string const& proxyBinary, std::list<std::string>& entryContents) {
+	Benchmark_Fixture fixture(params, proxyBinary);
+	fixture.create();
+	auto env = createEnv(fixture);
+	int generatedEntries = fixture.countGeneratedEntries();
+
+	std::shared_ptr<Model_ListCfg> listCfg, savedListCfg;
+
+	runner.run("readGeneratedFile", fixture, generatedEntries, [&] {
+		listCfg->loadStaticCfg();
+	}, [&] {
+		listCfg = createListCfg(env);
+	});
+
+	runner.run("load", fixture, generatedEntries, [&] {
+		listCfg->load();
+	}, [&] {
+		listCfg = createListCfg(env);
+	});
+
+	runner.run("sync", fixture, generatedEntries, [&] {
+		auto scriptMap = listCfg->repository.getScriptPathMap();
+		for (auto proxy : listCfg->proxies) {
+			proxy->unsync();
+			proxy->sync(true, true, scriptMap);
+		}
+	});
+
+	std::list<std::string> contents;
+	for (auto script : listCfg->repository) {
+		collectEntryContents(script->entries(), contents);
+	}
+	// same order as the parsers are registered by the client
+	runner.run("classifyEntries", fixture, contents.size(), [&] {
+		for (auto& content : contents) {
+			ContentParser_Tokenizer tokenizer(content);
+			std::vector<std::string> (ContentParser_Tokenizer::*matchers[])() const = {
+				&ContentParser_Tokenizer::matchLinux,
+				&ContentParser_Tokenizer::matchLinuxIso,
+				&ContentParser_Tokenizer::matchChainloader,
+				&ContentParser_Tokenizer::matchMemtest
+			};
+			for (auto matcher : matchers) {
+				try {
+					(tokenizer.*matcher)();
+					break;
+				} catch (ParserException const& e) {
+					continue;
+				}
+			}
+		}
+	});
+	entryContents.splice(entryContents.end(), contents);
+
+	savedListCfg = createListCfg(env);
+	savedListCfg->loadStaticCfg();
+	runner.run("compare", fixture, generatedEntries, [&] {
+		listCfg->compare(*savedListCfg);
+	});
+
+	if (proxyBinary != "") {
+		std::string proxyCmd = "'" + proxyBinary + "' '+*' multi < '" + fixture.getOutputFile() + "' > /dev/null";
+		runner.run("grubcfg-proxy", fixture, generatedEntries, [&] {
+			if (system(proxyCmd.c_str()) != 0) {
+				throw CmdExecException("failed running " + proxyCmd, __FILE__, __LINE__);
+			}
+		}, nullptr, false);
+	}
+
+	// save modifies the fixture, so it has to be the last one
+	runner.run("save", fixture, generatedEntries, [&] {
+		listCfg->save();
+	});
+}
+
+void usage() {
+	std::cerr << "usage: grub-customizer-benchmark [--iterations N] [--proxy-binary PATH] [--output FILE]" << std::endl
+	          << "         [--kernels N --submenu-depth N --os-prober-entries N --proxies N --custom-entries N]" << std::endl
+	          << "without fixture parameters a predefined matrix of fixtures is measured" << std::endl;
+}
+
+int main(int argc, char** argv) {
+	Benchmark_Runner runner;
+	std::string proxyBinary, outputFile;
+	Benchmark_Fixture::Params customParams;
+	bool useCustomParams = false;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			usage();
+			return 1;
+		}
+		std::string value = argv[++i];
+		if (arg == "--iterations") {
+			runner.iterations = std::max(1, std::atoi(value.c_str()));
+		} else if (arg == "--proxy-binary") {
+			proxyBinary = value;
+		} else if (arg == "--output") {
+			outputFile = value;
+		} else if (arg == "--kernels") {
+			customParams.kernels = std::atoi(value.c_str());
+			useCustomParams = true;
+		} else if (arg == "--submenu-depth") {
+			customParams.submenuDepth = std::atoi(value.c_str());
+			useCustomParams = true;
+		} else if (arg == "--os-prober-entries") {
+			customParams.osProberEntries = std::atoi(value.c_str());
+			useCustomParams = true;
+		} else if (arg == "--proxies") {
+			customParams.proxies = std::atoi(value.c_str());
+			useCustomParams = true;
+		} else if (arg == "--custom-entries") {
+			customParams.customEntries = std::atoi(value.c_str());
+			useCustomParams = true;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	std::list<Benchmark_Fixture::Params> matrix;
+	if (useCustomParams) {
+		matrix.push_back(customParams);
+	} else {
+		// scale one dimension at a time, starting from the defaults
+		Benchmark_Fixture::Params base;
+		matrix.push_back(base);
+		for (int kernels : {32, 128}) {
+			Benchmark_Fixture::Params params = base;
+			params.kernels = kernels;
+			matrix.push_back(params);
+		}
+		for (int depth : {4, 16}) {
+			Benchmark_Fixture::Params params = base;
+			params.kernels = 16;
+			params.submenuDepth = depth;
+			matrix.push_back(params);
+		}
+		for (int osProberEntries : {32, 128}) {
+			Benchmark_Fixture::Params params = base;
+			params.osProberEntries = osProberEntries;
+			matrix.push_back(params);
+		}
+		for (int proxies : {8, 32}) {
+			Benchmark_Fixture::Params params = base;
+			params.osProberEntries = 32;
+			params.proxies = proxies;
+			matrix.push_back(params);
+		}
+		for (int customEntries : {64, 256}) {
+			Benchmark_Fixture::Params params = base;
+			params.customEntries = customEntries;
+			matrix.push_back(params);
+		}
+	}
+
+	Benchmark_ContentParserCheck contentParserCheck;
+	try {
+		for (auto params : matrix) {
+			runFixture(runner, params, proxyBinary, contentParserCheck.corpus);
+		}
+	} catch (Exception const& e) {
+		std::cerr << "benchmark failed: " << std::string(e) << std::endl;
+		return 1;
+	}
+
+	Benchmark_StdRegex regexEngine;
+	std::list<std::string> differences = contentParserCheck.run(regexEngine);
+	for (auto& difference : differences) {
+		std::cerr << "content parser tokenizer differs from regex: " << difference << std::endl;
+	}
+	if (differences.size()) {
+		return 1;
+	}
+
+	if (outputFile != "") {
+		std::ofstream out(outputFile.c_str());
+		runner.printJson(out);
+	} else {
+		runner.printJson(std::cout);
+	}
+	return 0;
+}
@@ -32,7 +32,8 @@
 #include "../Controller/Helper/RuleMover/Strategy/MoveRuleOutOfProxyOnToplevel.hpp"
 #include "../Controller/Helper/RuleMover/Strategy/MoveRuleIntoForeignSubmenu.hpp"
 #include "../Controller/Helper/RuleMover/Strategy/MoveForeignRuleFromSubmenuToToplevel.hpp"
-#include "../lib/Logger/Stream.hpp"
+#include "../lib/Logger/Async.hpp"
+#include "../lib/Profiler/ChromeTrace.hpp"
 #include "../Mapper/EntryNameImpl.hpp"
 #include "../config.hpp"
 #include "../Controller/AboutController.hpp"
@@ -49,16 +50,47 @@
 
 int main(int argc, char** argv){
 	if (getuid() != 0 && (argc == 1 || argv[1] != std::string("no-fork"))) {
-		return system((std::string("pkexec ") + argv[0] + (argc == 2 ? std::string(" ") + argv[1] : "") + " no-fork").c_str());
+		std::string command = std::string("pkexec ") + argv[0];
+		for (int i = 1; i < argc; i++) {
+			command += std::string(" ") + argv[i];
+		}
+		return system((command + " no-fork").c_str());
 	}
 	setlocale(LC_ALL, "");
 	bindtextdomain("grub-customizer", LOCALEDIR);
 	textdomain("grub-customizer");
 
-	auto logger = std::make_shared<Logger_Stream>(std::cout);
+	auto logger = std::make_shared<Logger_Async>(std::cout);
 
 	Logger::getInstance() = logger;
 
+	Logger_Stream::LogLevel logLevel = Logger_Stream::LOG_EVENT;
+	bool trace = false, profileScripts = false;
+	for (int i = 1; i < argc; i++) {
+		std::string param = argv[i];
+		if (param == "debug") {
+			logLevel = Logger_Stream::LOG_DEBUG_ONLY;
+		} else if (param == "log-important") {
+			logLevel = Logger_Stream::LOG_IMPORTANT;
+		} else if (param == "quiet") {
+			logLevel = Logger_Stream::LOG_NOTHING;
+		} else if (param == "verbose") {
+			logLevel = Logger_Stream::LOG_VERBOSE;
+		} else if (param == "trace") {
+			trace = true;
+		} else if (param == "profile-scripts") {
+			profileScripts = true;
+		}
+	}
+
+	// "trace" records phase timings and writes them to TRACE_FILE on exit
+	std::shared_ptr<Profiler_ChromeTrace> profiler = nullptr;
+	if (trace) {
+		profiler = std::make_shared<Profiler_ChromeTrace>();
+		Profiler::getInstance() = profiler;
+	}
+
+	int exitCode = 0;
 	try {
 		auto application          = std::make_shared<Bootstrap_Application>(argc, argv);
 		auto view                 = std::make_shared<Bootstrap_View>();
@@ -83,19 +115,8 @@ int main(int argc, char** argv){
 		mainController->setSavedListCfg(savedListCfg);
 
 		// configure logger
-		logger->setLogLevel(Logger_Stream::LOG_EVENT);
-		if (argc > 1) {
-			std::string logParam = argv[1];
-			if (logParam == "debug") {
-				logger->setLogLevel(Logger_Stream::LOG_DEBUG_ONLY);
-			} else if (logParam == "log-important") {
-				logger->setLogLevel(Logger_Stream::LOG_IMPORTANT);
-			} else if (logParam == "quiet") {
-				logger->setLogLevel(Logger_Stream::LOG_NOTHING);
-			} else if (logParam == "verbose") {
-				logger->setLogLevel(Logger_Stream::LOG_VERBOSE);
-			}
-		}
+		logger->setLogLevel(logLevel);
+		factory->listcfg->profileScripts = profileScripts;
 
 		factory->contentParserFactory->registerParser(factory->create<ContentParser_Linux>(), gettext("Linux"));
 		factory->contentParserFactory->registerParser(factory->create<ContentParser_LinuxIso>(), gettext("Linux-ISO"));
@@ -117,7 +138,19 @@ int main(int argc, char** argv){
 		application->applicationObject->run();
 	} catch (Exception const& e) {
 		logger->log(e, Logger::ERROR);
-		return 1;
+		exitCode = 1;
+	}
+
+	if (profiler) {
+		try {
+			profiler->writeFile(TRACE_FILE);
+			logger->log(std::string("trace written to ") + TRACE_FILE, Logger::IMPORTANT_EVENT);
+		} catch (Exception const& e) {
+			logger->log(e, Logger::ERROR);
+		}
 	}
+	// the worker threads are detached - don't rely on the static logger instance being destroyed
+	logger->flush();
+	return exitCode;
 }
 
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <iostream>
+#include <string>
+#include <list>
+#include <cstdio>
+#include "../Benchmark/ContentParserCheck.hpp"
+#include "../lib/Regex/GLib.hpp"
+
+/**
+ * compares the menuentry tokenizer against the content parser patterns run by the regex engine
+ * of the application - run by "ctest" when glibmm is available. Additional grub.cfg files
+ * (like /boot/grub/grub.cfg) can be passed as arguments.
+ */
+
+int main(int argc, char** argv)
+{
+	Benchmark_ContentParserCheck contentParserCheck;
+	for (int i = 1; i < argc; i++) {
+		FILE* grubCfg = fopen(argv[i], "r");
+		if (!grubCfg) {
+			std::cerr << "cannot read " << argv[i] << std::endl;
+			return 1;
+		}
+		contentParserCheck.addGrubCfg(grubCfg);
+		fclose(grubCfg);
+	}
+
+	Regex_GLib regexEngine;
+	std::list<std::string> differences = contentParserCheck.run(regexEngine);
+	for (auto& difference : differences) {
+		std::cerr << "content parser tokenizer differs from regex: " << difference << std::endl;
+	}
+	if (differences.size()) {
+		return 1;
+	}
+	std::cout << contentParserCheck.corpus.size() << " entries checked" << std::endl;
+	return 0;
+}
@@ -19,8 +19,10 @@
 #include "../Model/Entry.hpp"
 #include <iostream>
 #include <memory>
-#include "../Model/ListCfg.hpp" // multi
+#include "../Model/GeneratedFileReader.hpp" // multi
 #include "../Model/Proxy.hpp"
+#include "../Model/Proxylist.hpp"
+#include "../Model/Repository.hpp"
 #include "../Model/Rule.hpp"
 #include "../Model/Script.hpp"
 
@@ -47,23 +49,23 @@ int main(int argc, char** argv){
 		}
 		return 0;
 	} else if (argc == 3 && std::string(argv[2]) == "multi") {
-		auto env = std::make_shared<Model_Env>();
-		Model_ListCfg scriptSource;
-		scriptSource.setEnv(env);
-		scriptSource.ignoreLock = true;
+		Model_Repository repository;
+		Model_Proxylist proxies;
 		{ // this scope prevents access to the unused proxy variable - push_back takes a copy!
 			auto proxy = std::make_shared<Model_Proxy>();
-			proxy->importRuleString(argv[1], env->cfg_dir_prefix);
-			scriptSource.proxies.push_back(proxy);
+			proxy->importRuleString(argv[1], "");
+			proxies.push_back(proxy);
 		}
-		scriptSource.readGeneratedFile(stdin, true, false);
+		Model_GeneratedFileReader reader(repository, proxies);
+		reader.createScriptIfNotFound = true;
+		reader.read(stdin);
 
-		scriptSource.proxies.front()->dataSource = scriptSource.repository.front(); // the first Script is always the main script
+		proxies.front()->dataSource = repository.front(); // the first Script is always the main script
 
-		auto map = scriptSource.repository.getScriptPathMap();
-		scriptSource.proxies.front()->sync(true, true, map);
+		auto map = repository.getScriptPathMap();
+		proxies.front()->sync(true, true, map);
 
-		for (auto& rule : scriptSource.proxies.front()->rules) {
+		for (auto& rule : proxies.front()->rules) {
 			rule->print(std::cout);
 		}
 	} else {
@@ -0,0 +1,601 @@
+/*
+ * Copyright (C) 2010-2011 Daniel Richter <danielrichter2007@web.de>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+#include <functional>
+#include <algorithm>
+#include <sstream>
+#include <memory>
+#include "../Controller/Helper/DispatchQueue.hpp"
+#include "../Controller/Helper/TaskGraph.hpp"
+#include "../Controller/Helper/WorkerPool.hpp"
+#include "../Model/ProgressChannel.hpp"
+#include "../Model/ScriptDirectory.hpp"
+#include "../lib/Process.hpp"
+#include "../lib/Logger/Async.hpp"
+#include "../Model/DeviceDataList.hpp"
+#include "../Model/FbResolutionsGetter.hpp"
+#include "../Model/GeneratedFileReader.hpp"
+
+/**
+ * unit tests for code which doesn't need gtk/glib - run by "ctest"
+ */
+
+int failures = 0;
+
+void check(bool condition, std::string const& description)
+{
+	if (!condition) {
+		std::cerr << "FAILED: " << description << std::endl;
+		failures++;
+	}
+}
+
+void testDispatchQueueWakeup()
+{
+	Controller_Helper_DispatchQueue queue;
+	int calls = 0;
+	check(queue.push("", [&] {calls++;}), "first push requests a wakeup");
+	check(!queue.push("", [&] {calls++;}), "second push of the same batch doesn't request a wakeup");
+	queue.runAll([] (std::string const&) {});
+	check(calls == 2, "all functions of the batch are run");
+	check(queue.push("", [&] {calls++;}), "first push after runAll requests a wakeup again");
+}
+
+void testDispatchQueueCoalescing()
+{
+	Controller_Helper_DispatchQueue queue;
+	int calls = 0;
+	queue.push("sync", [&] {calls++;});
+	queue.push("sync", [&] {calls++;});
+	queue.push("other", [&] {calls += 10;});
+	queue.runAll([] (std::string const&) {});
+	check(calls == 11, "functions using the same key are queued once per batch");
+
+	queue.push("sync", [&] {calls++;});
+	queue.runAll([] (std::string const&) {});
+	check(calls == 12, "keys can be queued again after runAll");
+}
+
+void testDispatchQueueOrderAndReentrance()
+{
+	Controller_Helper_DispatchQueue queue;
+	std::string order;
+	queue.push("", [&] {
+		order += "a";
+		queue.push("", [&] {order += "c";}); // queued while running - belongs to the next batch
+	});
+	queue.push("", [&] {order += "b";});
+	queue.runAll([] (std::string const&) {});
+	check(order == "ab", "functions are run in order, functions queued meanwhile wait for the next batch");
+	queue.runAll([] (std::string const&) {});
+	check(order == "abc", "the next batch runs the functions queued meanwhile");
+}
+
+void testDispatchQueueErrors()
+{
+	Controller_Helper_DispatchQueue queue;
+	int calls = 0;
+	std::vector<std::string> errors;
+	queue.push("", [&] {calls++;});
+	queue.push("", [] {throw LogicException("broken", __FILE__, __LINE__);});
+	queue.push("", [] {throw 42;});
+	queue.push("", [&] {calls++;});
+	queue.runAll([&] (std::string const& message) {errors.push_back(message);});
+	check(calls == 2, "an exception doesn't drop the rest of the batch");
+	check(errors.size() == 2, "each exception is reported");
+}
+
+void testDispatchQueueConcurrentPush()
+{
+	Controller_Helper_DispatchQueue queue;
+	std::atomic<int> wakeups(0);
+	int calls = 0;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 8; i++) {
+		threads.push_back(std::thread([&] {
+			for (int j = 0; j < 1000; j++) {
+				if (queue.push("", [&] {calls++;})) {
+					wakeups++;
+				}
+			}
+		}));
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	queue.runAll([] (std::string const&) {});
+	check(wakeups == 1, "concurrent pushes request a single wakeup");
+	check(calls == 8000, "no concurrently pushed function is lost");
+}
+
+// waits up to 5 seconds
+bool waitFor(std::function<bool ()> condition)
+{
+	for (int i = 0; i < 500 && !condition(); i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return condition();
+}
+
+void testWorkerPoolSurvivesFailures()
+{
+	Controller_Helper_WorkerPool pool(1);
+	std::mutex mutex;
+	std::vector<std::string> errors;
+	std::atomic<int> calls(0);
+	auto onError = [&] (std::string const& message) {
+		std::lock_guard<std::mutex> lock(mutex);
+		errors.push_back(message);
+	};
+	pool.run([] {throw LogicException("broken", __FILE__, __LINE__);}, onError);
+	pool.run([] {throw std::runtime_error("broken");}, onError);
+	pool.run([] {throw 42;}, onError);
+	pool.run([&] {calls++;}, [] (std::string const& message) {throw 42;});
+	pool.run([] {throw 42;}, [] (std::string const& message) {throw 42;}); // failing error handler
+	pool.run([&] {calls++;}, onError);
+
+	check(waitFor([&] {return calls == 2;}), "tasks queued after failing tasks are run");
+	std::lock_guard<std::mutex> lock(mutex);
+	check(errors.size() == 3, "each exception is reported");
+	check(pool.getThreadCount() == 1, "failing tasks don't end the worker");
+}
+
+void testWorkerPoolThreadLimit()
+{
+	Controller_Helper_WorkerPool pool(2);
+	std::atomic<int> running(0), maxRunning(0), calls(0);
+	for (int i = 0; i < 10; i++) {
+		pool.run([&] {
+			int nowRunning = ++running;
+			int previousMax = maxRunning;
+			while (nowRunning > previousMax && !maxRunning.compare_exchange_weak(previousMax, nowRunning)) {}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			running--;
+			calls++;
+		}, [] (std::string const&) {});
+	}
+	check(waitFor([&] {return calls == 10;}), "all tasks are run");
+	check(maxRunning <= 2, "no more tasks than workers run at the same time");
+	check(pool.getThreadCount() <= 2, "no more workers than allowed are started");
+}
+
+void testProgressChannelTrailingNotification()
+{
+	Model_ProgressChannel channel(1);
+	check(channel.publish(0, "first", 1, 3), "the first update is always notified");
+	check(!channel.publish(0.3, "second", 2, 3), "updates within the frame interval are suppressed");
+	check(channel.requestTrailingNotification(), "the first suppressed update schedules a trailing notification");
+	check(!channel.publish(0.6, "third", 3, 3), "further updates are suppressed");
+	check(!channel.requestTrailingNotification(), "only one trailing notification is scheduled");
+	check(channel.takeTrailingNotification(), "the trailing notification is delivered");
+	check(channel.get()->name == "third", "the trailing notification shows the latest update");
+	check(!channel.takeTrailingNotification(), "the trailing notification is delivered once");
+
+	channel.publish(0.8);
+	channel.requestTrailingNotification();
+	check(channel.publish(1), "the last update is always notified");
+	check(!channel.takeTrailingNotification(), "a regular notification makes the pending trailing one obsolete");
+}
+
+void testScriptDirectoryChangeDetection()
+{
+	char dirTemplate[] = "/tmp/grub-customizer_test.XXXXXX";
+	std::string dir = mkdtemp(dirTemplate);
+	std::string script = dir + "/10_linux";
+	FILE* file = fopen(script.c_str(), "w");
+	fputs("#!/bin/sh\necho\n", file);
+	fclose(file);
+	chmod(script.c_str(), 0755);
+
+	Model_ScriptDirectory scriptDir;
+	check(scriptDir.load(dir), "the script directory is loaded");
+	check(scriptDir.isUpToDate(), "an unchanged directory is up to date");
+
+	chmod(script.c_str(), 0644);
+	check(!scriptDir.isUpToDate(), "changed permissions are detected");
+
+	scriptDir.load(dir);
+	file = fopen(script.c_str(), "a");
+	fputs("echo\n", file);
+	fclose(file);
+	check(!scriptDir.isUpToDate(), "in place edits are detected");
+
+	scriptDir.load(dir);
+	unlink(script.c_str());
+	check(!scriptDir.isUpToDate(), "removed files are detected");
+	rmdir(dir.c_str());
+}
+
+std::string readAll(FILE* stream)
+{
+	std::string result;
+	int c;
+	while ((c = fgetc(stream)) != EOF) {
+		result += char(c);
+	}
+	return result;
+}
+
+void testProcessIgnoresBackgroundProcesses()
+{
+	Process process("sleep 3 & echo out; echo err >&2; exit 3");
+	process.timeout = 10;
+	auto start = std::chrono::steady_clock::now();
+	std::string output = readAll(process.start());
+	int status = process.wait();
+	check(std::chrono::steady_clock::now() - start < std::chrono::seconds(2), "background processes keeping the pipes open aren't waited for");
+	check(output == "out\n", "the output is read completely");
+	check(process.getErrorOutput() == "err\n", "the error output is read completely");
+	check(WIFEXITED(status) && WEXITSTATUS(status) == 3, "the exit status is returned");
+	check(!process.isTimedOut(), "the command didn't time out");
+}
+
+void testProcessTimeout()
+{
+	Process process("echo out; sleep 5");
+	process.timeout = 1;
+	std::string output = readAll(process.start());
+	int status = process.wait();
+	check(process.isTimedOut(), "the timeout is detected");
+	check(output == "out\n", "the output written before the timeout is read");
+	check(WIFSIGNALED(status), "the command gets killed");
+}
+
+// runs functions in plain threads, dispatched functions are run directly
+class TestThreadHelper : public Controller_Helper_Thread
+{
+	private: std::vector<std::thread> threads;
+	private: std::mutex mutex;
+
+	public: void runDispatched(std::function<void ()> function)
+	{
+		function();
+	}
+
+	public: void runDispatchedCoalesced(std::string const& key, std::function<void ()> function)
+	{
+		function();
+	}
+
+	public: void runDelayed(std::function<void ()> function, int delayInMilliSec)
+	{
+		function();
+	}
+
+	public: void runAsThread(std::function<void ()> function)
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->threads.push_back(std::thread(function));
+	}
+
+	public: void joinAll()
+	{
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			std::swap(threads, this->threads);
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+};
+
+void testTaskGraphFinishesAfterFailures()
+{
+	auto threadHelper = std::make_shared<TestThreadHelper>();
+	auto graph = std::make_shared<Controller_Helper_TaskGraph>(threadHelper);
+	std::atomic<int> errors(0);
+	std::atomic<bool> finished(false), dependentTaskRun(false);
+	graph->addTask("exception", {}, [] {throw LogicException("broken", __FILE__, __LINE__);});
+	graph->addTask("std::exception", {}, [] {std::stoi("no number");});
+	graph->addTask("unknown", {}, [] {throw 42;});
+	graph->addTask("dependent", {"exception", "std::exception", "unknown"}, [&] {dependentTaskRun = true;});
+	graph->run([&] {finished = true;}, [&] (Exception const& e) {errors++;});
+
+	waitFor([&] {return bool(finished);});
+	threadHelper->joinAll();
+	check(finished, "onFinish is called although tasks have thrown");
+	check(errors == 3, "every kind of exception is reported");
+	check(dependentTaskRun, "tasks depending on failed tasks are run");
+}
+
+void testAsyncLoggerWrapAround()
+{
+	std::ostringstream output;
+	{
+		Logger_Async logger(output, 4);
+		logger.setLogLevel(Logger_Stream::LOG_VERBOSE);
+		for (int i = 0; i < 100; i++) {
+			logger.log("message " + std::to_string(i), Logger::INFO);
+		}
+		logger.flush();
+		std::string result = output.str();
+		size_t lastPos = 0;
+		bool ordered = true;
+		for (int i = 0; i < 100; i++) {
+			size_t pos = result.find("[message " + std::to_string(i) + "]", lastPos);
+			if (pos == std::string::npos) {
+				ordered = false;
+				break;
+			}
+			lastPos = pos;
+		}
+		check(ordered, "messages survive wrapping around a full ring buffer in order");
+	}
+}
+
+void testAsyncLoggerMultipleProducers()
+{
+	std::ostringstream output;
+	{
+		Logger_Async logger(output, 8);
+		logger.setLogLevel(Logger_Stream::LOG_VERBOSE);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++) {
+			threads.push_back(std::thread([&logger, t] {
+				for (int i = 0; i < 250; i++) {
+					logger.log("thread " + std::to_string(t) + " message " + std::to_string(i), Logger::INFO);
+				}
+			}));
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		logger.flush();
+	}
+	std::string result = output.str();
+	bool complete = true;
+	for (int t = 0; t < 4 && complete; t++) {
+		size_t lastPos = 0;
+		for (int i = 0; i < 250; i++) {
+			size_t pos = result.find("[thread " + std::to_string(t) + " message " + std::to_string(i) + "]", lastPos);
+			if (pos == std::string::npos) {
+				complete = false;
+				break;
+			}
+			lastPos = pos;
+		}
+	}
+	check(complete, "messages of concurrent producers are all written, in order per thread");
+	check(std::count(result.begin(), result.end(), '\n') == 1000, "no message is written twice");
+}
+
+void testAsyncLoggerFlushesErrors()
+{
+	std::ostringstream output;
+	Logger_Async logger(output, 8);
+	logger.setLogLevel(Logger_Stream::LOG_NOTHING);
+	logger.log("broken", Logger::ERROR);
+	check(output.str().find("broken") != std::string::npos, "errors are written before log() returns");
+}
+
+void testAsyncLoggerDrainsOnDestruction()
+{
+	std::ostringstream output;
+	{
+		Logger_Async logger(output, 8);
+		logger.setLogLevel(Logger_Stream::LOG_VERBOSE);
+		for (int i = 0; i < 20; i++) {
+			logger.log("pending " + std::to_string(i), Logger::INFO);
+		}
+	}
+	check(output.str().find("[pending 19]") != std::string::npos, "pending messages are written on destruction");
+}
+
+void testAsyncLoggerActionSeparator()
+{
+	std::ostringstream output;
+	{
+		Logger_Async logger(output, 8);
+		logger.setLogLevel(Logger_Stream::LOG_VERBOSE);
+		logger.logActionBegin("Main", "outer");
+		logger.logActionBegin("Main", "inner");
+		logger.logActionEnd();
+		logger.logActionEnd();
+	}
+	std::string result = output.str();
+	check(result.find("\n\n") == result.size() - 2, "only the top level action is followed by a blank line");
+}
+
+// creates the file including its parent directories
+void writeTestFile(std::string const& path, std::string const& content)
+{
+	for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+		mkdir(path.substr(0, pos).c_str(), 0755);
+	}
+	FILE* file = fopen(path.c_str(), "w");
+	fputs(content.c_str(), file);
+	fclose(file);
+}
+
+void removeTestDir(std::string const& dir)
+{
+	check(system(("rm -rf '" + dir + "'").c_str()) == 0, "the test directory " + dir + " is removed");
+}
+
+void testDeviceDataListFromSystem()
+{
+	char dirTemplate[] = "/tmp/grub-customizer_test.XXXXXX";
+	std::string root = mkdtemp(dirTemplate);
+	writeTestFile(root + "/sys/class/block/sda1/dev", "8:1\n");
+	writeTestFile(root + "/sys/class/block/dm-0/dev", "253:0\n");
+	writeTestFile(root + "/run/udev/data/b8:1", "S:disk/by-uuid/1234-ABCD\nE:ID_FS_TYPE=vfat\n");
+	writeTestFile(root + "/run/udev/data/b253:0", "E:ID_FS_TYPE=ext4\n");
+	writeTestFile(root + "/dev/disk/by-uuid/.keep", "");
+	writeTestFile(root + "/dev/disk/by-label/.keep", "");
+	symlink("../../sda1", (root + "/dev/disk/by-uuid/1234-ABCD").c_str());
+	symlink("../../dm-0", (root + "/dev/disk/by-uuid/0b1c-root").c_str());
+	symlink("../../sda1", (root + "/dev/disk/by-label/EFI\\x20System").c_str());
+	symlink("../../dm-0", (root + "/dev/disk/by-label/root").c_str());
+
+	Model_DeviceDataList deviceDataList;
+	check(deviceDataList.loadFromSystem(root), "devices are found in the fake tree");
+	check(deviceDataList["/dev/sda1"]["UUID"] == "1234-ABCD", "the uuid is taken from by-uuid");
+	check(deviceDataList["/dev/sda1"]["LABEL"] == "EFI System", "\\xNN escapes of labels are decoded");
+	check(deviceDataList["/dev/sda1"]["TYPE"] == "vfat", "the filesystem type is taken from the udev data");
+	check(deviceDataList["/dev/dm-0"]["TYPE"] == "ext4", "device mapper devices are named by their kernel name");
+	check(deviceDataList.getDeviceByUuid("0b1c-root") == "/dev/dm-0", "devices are found by uuid");
+	check(deviceDataList.getDeviceByLabel("EFI System") == "/dev/sda1", "devices are found by decoded label");
+	bool notFound = false;
+	try {
+		deviceDataList.getDeviceByUuid("unknown");
+	} catch (ItemNotFoundException const& e) {
+		notFound = true;
+	}
+	check(notFound, "unknown uuids throw ItemNotFoundException");
+
+	Model_DeviceDataList emptyList;
+	check(!emptyList.loadFromSystem(root + "/missing"), "loadFromSystem fails without device information");
+	removeTestDir(root);
+}
+
+class TestFbResolutionsGetter : public Model_FbResolutionsGetter
+{
+	public: using Model_FbResolutionsGetter::readSysfsModes;
+	public: using Model_FbResolutionsGetter::getHardwareFingerprint;
+	public: using Model_FbResolutionsGetter::readCache;
+	public: using Model_FbResolutionsGetter::writeCache;
+};
+
+void testFbResolutionsFromSysfs()
+{
+	char dirTemplate[] = "/tmp/grub-customizer_test.XXXXXX";
+	std::string root = mkdtemp(dirTemplate);
+	writeTestFile(root + "/sys/class/drm/card0/device/vendor", "0x8086\n");
+	writeTestFile(root + "/sys/class/drm/card0-HDMI-A-1/status", "connected\n");
+	writeTestFile(root + "/sys/class/drm/card0-HDMI-A-1/modes", "1920x1080\n1920x1080i\n1280x720\n1920x1080\n");
+	writeTestFile(root + "/sys/class/drm/card0-DP-1/status", "disconnected\n");
+	writeTestFile(root + "/sys/class/drm/card0-DP-1/modes", "800x600\n");
+	writeTestFile(root + "/sys/class/graphics/fb0/bits_per_pixel", "32\n");
+	writeTestFile(root + "/sys/class/graphics/fb0/modes", "U:1024x768p-0\nS:640x480p-60\n");
+
+	TestFbResolutionsGetter getter;
+	getter.rootDir = root;
+	std::list<std::string> modes = getter.readSysfsModes();
+	std::list<std::string> expectedModes = {"1920x1080", "1280x720", "1024x768x32", "640x480x32"};
+	check(modes == expectedModes, "connected drm modes without interlaced modes and duplicates, fb modes with color depth");
+
+	writeTestFile(root + "/sys/class/graphics/fb0/bits_per_pixel", "");
+	check(getter.readSysfsModes().back() == "640x480", "fb modes have no color depth if bits_per_pixel is empty");
+	removeTestDir(root);
+}
+
+void testFbResolutionsCache()
+{
+	char dirTemplate[] = "/tmp/grub-customizer_test.XXXXXX";
+	std::string root = mkdtemp(dirTemplate);
+	writeTestFile(root + "/sys/class/dmi/id/board_name", "board\n");
+	writeTestFile(root + "/sys/class/drm/card0/device/vendor", "0x8086\n");
+
+	TestFbResolutionsGetter getter;
+	getter.rootDir = root;
+	getter.cacheFile = root + "/cache/fb_resolutions";
+	std::string fingerprint = getter.getHardwareFingerprint();
+	std::list<std::string> modes = {"1024x768x32", "800x600x16"};
+	getter.writeCache(fingerprint, modes);
+
+	std::list<std::string> cachedModes;
+	check(getter.readCache(fingerprint, cachedModes), "the cache is read for the same hardware");
+	check(cachedModes == modes, "the cached modes are returned unchanged");
+
+	writeTestFile(root + "/sys/class/drm/card0/device/vendor", "0x1002\n");
+	check(getter.getHardwareFingerprint() != fingerprint, "changed graphics hardware changes the fingerprint");
+	std::list<std::string> outdatedModes;
+	check(!getter.readCache(getter.getHardwareFingerprint(), outdatedModes), "the cache of other hardware is ignored");
+
+	getter.writeCache(fingerprint, {"640x480x8"});
+	cachedModes.clear();
+	getter.readCache(fingerprint, cachedModes);
+	check(cachedModes == std::list<std::string>({"640x480x8"}), "an existing cache is replaced");
+	removeTestDir(root);
+}
+
+void testGeneratedFileReaderPassesLogger()
+{
+	std::string config = "### BEGIN /etc/grub.d/10_linux ###\n"
+		"insmod gzio\n"
+		"menuentry 'Linux' {\n"
+		"\tlinux /vmlinuz\n"
+		"}\n"
+		"submenu 'Advanced' {\n"
+		"\tmenuentry 'Linux (recovery)' {\n"
+		"\t\tlinux /vmlinuz single\n"
+		"\t}\n"
+		"}\n"
+		"### END /etc/grub.d/10_linux ###\n";
+	FILE* source = fmemopen(&config[0], config.size(), "r");
+
+	std::ostringstream output;
+	auto logger = std::make_shared<Logger_Stream>(output);
+	Model_Repository repository;
+	Model_Proxylist proxies;
+	Model_GeneratedFileReader reader(repository, proxies);
+	reader.createScriptIfNotFound = true;
+	reader.logger = logger;
+	reader.read(source);
+	fclose(source);
+
+	check(repository.size() == 1 && repository.front()->entries().size() == 3, "plaintext, menuentry and submenu are read");
+	bool allLogged = repository.size() == 1;
+	for (auto& entry : repository.size() ? repository.front()->entries() : std::list<std::shared_ptr<Model_Entry>>()) {
+		allLogged = allLogged && entry->getLogger() == logger;
+		for (auto& subEntry : entry->subEntries) {
+			allLogged = allLogged && subEntry->getLogger() == logger;
+		}
+	}
+	check(allLogged, "the entries created by the reader get its logger");
+}
+
+int main(int argc, char** argv)
+{
+	testDispatchQueueWakeup();
+	testDispatchQueueCoalescing();
+	testDispatchQueueOrderAndReentrance();
+	testDispatchQueueErrors();
+	testDispatchQueueConcurrentPush();
+	testWorkerPoolSurvivesFailures();
+	testWorkerPoolThreadLimit();
+	testTaskGraphFinishesAfterFailures();
+	testProgressChannelTrailingNotification();
+	testScriptDirectoryChangeDetection();
+	testProcessIgnoresBackgroundProcesses();
+	testProcessTimeout();
+	testAsyncLoggerWrapAround();
+	testAsyncLoggerMultipleProducers();
+	testAsyncLoggerFlushesErrors();
+	testAsyncLoggerDrainsOnDestruction();
+	testAsyncLoggerActionSeparator();
+	testDeviceDataListFromSystem();
+	testFbResolutionsFromSysfs();
+	testFbResolutionsCache();
+	testGeneratedFileReaderPassesLogger();
+
+	if (failures == 0) {
+		std::cout << "all tests passed" << std::endl;
+	}
+	return failures == 0 ? 0 : 1;
+}